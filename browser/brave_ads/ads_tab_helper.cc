@@ -77,10 +77,22 @@ void AdsTabHelper::RunIsolatedJavaScript(
     content::RenderFrameHost* render_frame_host) {
   DCHECK(render_frame_host);
 
-  dom_distiller::RunIsolatedJavaScript(
-      render_frame_host, "new XMLSerializer().serializeToString(document)",
-      base::BindOnce(&AdsTabHelper::OnJavaScriptHtmlResult,
-                     weak_factory_.GetWeakPtr()));
+  // Ads ignore pages which were not served over HTTP or HTTPS
+  if (redirect_chain_.empty() ||
+      !redirect_chain_.back().SchemeIsHTTPOrHTTPS()) {
+    return;
+  }
+
+  // The HTML is only searched for conversion ids, so don't serialize the DOM
+  // unless conversions are tracked
+  if (ads_service_->ShouldAllowConversionTracking()) {
+    dom_distiller::RunIsolatedJavaScript(
+        render_frame_host, "new XMLSerializer().serializeToString(document)",
+        base::BindOnce(&AdsTabHelper::OnJavaScriptHtmlResult,
+                       weak_factory_.GetWeakPtr()));
+  } else {
+    ads_service_->OnHtmlLoaded(tab_id_, redirect_chain_, "");
+  }
 
   dom_distiller::RunIsolatedJavaScript(
       render_frame_host, "document?.body?.innerText",
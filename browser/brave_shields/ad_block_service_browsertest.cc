@@ -11,9 +11,11 @@
 
 #include "base/base64.h"
 #include "base/path_service.h"
+#include "base/run_loop.h"
 #include "base/task/post_task.h"
 #include "base/test/thread_test_helper.h"
 #include "brave/browser/brave_browser_process.h"
+#include "brave/browser/brave_shields/brave_shields_web_contents_observer.h"
 #include "brave/browser/net/brave_ad_block_tp_network_delegate_helper.h"
 #include "brave/common/brave_paths.h"
 #include "brave/common/pref_names.h"
@@ -30,16 +32,20 @@
 #include "chrome/browser/content_settings/host_content_settings_map_factory.h"
 #include "chrome/browser/extensions/extension_browsertest.h"
 #include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
 #include "chrome/common/chrome_features.h"
 #include "chrome/test/base/ui_test_utils.h"
+#include "components/prefs/pref_change_registrar.h"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/test/browser_test.h"
 #include "content/public/test/browser_test_utils.h"
+#include "content/public/test/test_utils.h"
 #include "extensions/test/extension_test_message_listener.h"
 #include "net/dns/mock_host_resolver.h"
 #include "services/network/host_resolver.h"
+#include "ui/base/window_open_disposition.h"
 
 const char kAdBlockTestPage[] = "/blocking.html";
 
@@ -75,6 +81,8 @@ using content::BrowserThread;
 void AdBlockServiceTest::SetUpOnMainThread() {
   ExtensionBrowserTest::SetUpOnMainThread();
   host_resolver()->AddRule("*", "127.0.0.1");
+  brave_shields::BraveShieldsWebContentsObserver::
+      SetFlushBlockedCountsDelayForTesting(base::TimeDelta());
 }
 
 void AdBlockServiceTest::SetUp() {
@@ -239,6 +247,68 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, AdsGetBlockedByDefaultBlocker) {
   EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
 }
 
+// Keeps the default delay before blocked counts are written to prefs.
+class AdBlockServiceBatchedStatsTest : public AdBlockServiceTest {
+ public:
+  void SetUpOnMainThread() override {
+    AdBlockServiceTest::SetUpOnMainThread();
+    brave_shields::BraveShieldsWebContentsObserver::
+        ResetFlushBlockedCountsDelayForTesting();
+  }
+
+ protected:
+  // Blocks an ad image in a new foreground tab.
+  content::WebContents* BlockAdInNewTab() {
+    GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
+    ui_test_utils::NavigateToURLWithDisposition(
+        browser(), url, WindowOpenDisposition::NEW_FOREGROUND_TAB,
+        ui_test_utils::BROWSER_TEST_WAIT_FOR_LOAD_STOP);
+    content::WebContents* contents =
+        browser()->tab_strip_model()->GetActiveWebContents();
+    EXPECT_EQ(true, EvalJs(contents,
+                           "setExpectations(0, 1, 0, 0);"
+                           "addImage('ad_banner.png')"));
+    return contents;
+  }
+};
+
+// Blocked ads are only counted once the flush timer fires.
+IN_PROC_BROWSER_TEST_F(AdBlockServiceBatchedStatsTest,
+                       AdsBlockedCountWrittenWhenTimerFires) {
+  ASSERT_TRUE(InstallDefaultAdBlockExtension());
+  PrefService* prefs = browser()->profile()->GetPrefs();
+  EXPECT_EQ(prefs->GetUint64(kAdsBlocked), 0ULL);
+
+  base::RunLoop run_loop;
+  PrefChangeRegistrar registrar;
+  registrar.Init(prefs);
+  registrar.Add(kAdsBlocked, run_loop.QuitClosure());
+
+  BlockAdInNewTab();
+  EXPECT_EQ(prefs->GetUint64(kAdsBlocked), 0ULL);
+
+  run_loop.Run();
+  EXPECT_EQ(prefs->GetUint64(kAdsBlocked), 1ULL);
+}
+
+// Blocked ads which are still pending are counted when the tab closes.
+IN_PROC_BROWSER_TEST_F(AdBlockServiceBatchedStatsTest,
+                       AdsBlockedCountWrittenWhenTabCloses) {
+  ASSERT_TRUE(InstallDefaultAdBlockExtension());
+  PrefService* prefs = browser()->profile()->GetPrefs();
+  EXPECT_EQ(prefs->GetUint64(kAdsBlocked), 0ULL);
+
+  content::WebContents* contents = BlockAdInNewTab();
+  EXPECT_EQ(prefs->GetUint64(kAdsBlocked), 0ULL);
+
+  content::WebContentsDestroyedWatcher destroyed_watcher(contents);
+  TabStripModel* tab_strip_model = browser()->tab_strip_model();
+  tab_strip_model->CloseWebContentsAt(tab_strip_model->active_index(),
+                                      TabStripModel::CLOSE_NONE);
+  destroyed_watcher.Wait();
+  EXPECT_EQ(prefs->GetUint64(kAdsBlocked), 1ULL);
+}
+
 // Load a page with an image which is not an ad, and make sure it is NOT
 // blocked by custom filters.
 IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
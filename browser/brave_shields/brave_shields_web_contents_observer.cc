@@ -5,12 +5,14 @@
 
 #include "brave/browser/brave_shields/brave_shields_web_contents_observer.h"
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/no_destructor.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/common/pref_names.h"
@@ -54,6 +56,16 @@ using content::WebContents;
 
 namespace {
 
+// Stats only need to be roughly up to date, e.g. for the new tab page.
+constexpr base::TimeDelta kFlushBlockedCountsDelay =
+    base::TimeDelta::FromSeconds(5);
+
+base::TimeDelta g_flush_blocked_counts_delay = kFlushBlockedCountsDelay;
+
+size_t HashSubresource(const std::string& subresource) {
+  return std::hash<std::string>()(subresource);
+}
+
 // Content Settings are only sent to the main frame currently. Chrome may fix
 // this at some point, but for now we do this as a work-around. You can verify
 // if this is fixed by running the following test: npm run test --
@@ -137,6 +149,10 @@ void BraveShieldsWebContentsObserver::DidFinishNavigation(
   (*frame_tree_node_id_to_tab_url_)[tree_node_id] = web_contents()->GetURL();
 }
 
+void BraveShieldsWebContentsObserver::WebContentsDestroyed() {
+  FlushBlockedCounts();
+}
+
 // static
 GURL BraveShieldsWebContentsObserver::GetTabURLFromRenderFrameInfo(
     int render_frame_tree_node_id) {
@@ -153,12 +169,60 @@ GURL BraveShieldsWebContentsObserver::GetTabURLFromRenderFrameInfo(
 
 bool BraveShieldsWebContentsObserver::IsBlockedSubresource(
     const std::string& subresource) {
-  return blocked_url_paths_.find(subresource) != blocked_url_paths_.end();
+  return blocked_url_paths_.find(HashSubresource(subresource)) !=
+         blocked_url_paths_.end();
 }
 
 void BraveShieldsWebContentsObserver::AddBlockedSubresource(
     const std::string& subresource) {
-  blocked_url_paths_.insert(subresource);
+  blocked_url_paths_.insert(HashSubresource(subresource));
+}
+
+void BraveShieldsWebContentsObserver::IncrementBlockedCount(
+    const std::string& pref_name) {
+  pending_blocked_counts_[pref_name]++;
+
+  if (g_flush_blocked_counts_delay.is_zero()) {
+    FlushBlockedCounts();
+    return;
+  }
+
+  if (!flush_blocked_counts_timer_.IsRunning()) {
+    flush_blocked_counts_timer_.Start(
+        FROM_HERE, g_flush_blocked_counts_delay,
+        base::BindOnce(&BraveShieldsWebContentsObserver::FlushBlockedCounts,
+                       base::Unretained(this)));
+  }
+}
+
+void BraveShieldsWebContentsObserver::FlushBlockedCounts() {
+  flush_blocked_counts_timer_.Stop();
+
+  if (pending_blocked_counts_.empty() || !web_contents()) {
+    return;
+  }
+
+  PrefService* prefs =
+      Profile::FromBrowserContext(web_contents()->GetBrowserContext())
+          ->GetOriginalProfile()
+          ->GetPrefs();
+  for (const auto& pending_blocked_count : pending_blocked_counts_) {
+    const std::string& pref_name = pending_blocked_count.first;
+    prefs->SetUint64(
+        pref_name, prefs->GetUint64(pref_name) + pending_blocked_count.second);
+  }
+  pending_blocked_counts_.clear();
+}
+
+// static
+void BraveShieldsWebContentsObserver::SetFlushBlockedCountsDelayForTesting(
+    base::TimeDelta delay) {
+  g_flush_blocked_counts_delay = delay;
+}
+
+// static
+void BraveShieldsWebContentsObserver::ResetFlushBlockedCountsDelayForTesting() {
+  g_flush_blocked_counts_delay = kFlushBlockedCountsDelay;
 }
 
 // static
@@ -178,27 +242,21 @@ void BraveShieldsWebContentsObserver::DispatchBlockedEvent(
         BraveShieldsWebContentsObserver::FromWebContents(web_contents);
     if (observer && !observer->IsBlockedSubresource(subresource)) {
       observer->AddBlockedSubresource(subresource);
-      PrefService* prefs =
-          Profile::FromBrowserContext(web_contents->GetBrowserContext())
-              ->GetOriginalProfile()
-              ->GetPrefs();
 
       if (block_type == kAds) {
-        prefs->SetUint64(kAdsBlocked, prefs->GetUint64(kAdsBlocked) + 1);
+        observer->IncrementBlockedCount(kAdsBlocked);
       } else if (block_type == kHTTPUpgradableResources) {
-        prefs->SetUint64(kHttpsUpgrades, prefs->GetUint64(kHttpsUpgrades) + 1);
+        observer->IncrementBlockedCount(kHttpsUpgrades);
       } else if (block_type == kJavaScript) {
-        prefs->SetUint64(kJavascriptBlocked,
-                         prefs->GetUint64(kJavascriptBlocked) + 1);
+        observer->IncrementBlockedCount(kJavascriptBlocked);
       } else if (block_type == kFingerprintingV2) {
-        prefs->SetUint64(kFingerprintingBlocked,
-                         prefs->GetUint64(kFingerprintingBlocked) + 1);
+        observer->IncrementBlockedCount(kFingerprintingBlocked);
       }
     }
   }
 #if BUILDFLAG(ENABLE_BRAVE_PERF_PREDICTOR)
   brave_perf_predictor::PerfPredictorTabHelper::DispatchBlockedEvent(
-      request_url.spec(), frame_tree_node_id);
+      request_url, frame_tree_node_id);
 #endif
 }
 
@@ -214,7 +272,11 @@ void BraveShieldsWebContentsObserver::DispatchBlockedEventForWebContents(
   }
   EventRouter* event_router =
       EventRouter::Get(web_contents->GetBrowserContext());
-  if (event_router) {
+  // Don't build events nobody listens to, pages can block hundreds of
+  // requests a second.
+  if (event_router &&
+      event_router->HasEventListener(
+          extensions::api::brave_shields::OnBlocked::kEventName)) {
     extensions::api::brave_shields::OnBlocked::Details details;
     details.tab_id = extensions::ExtensionTabUtil::GetTabId(web_contents);
     details.block_type = block_type;
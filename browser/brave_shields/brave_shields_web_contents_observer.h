@@ -7,13 +7,14 @@
 #define BRAVE_BROWSER_BRAVE_SHIELDS_BRAVE_SHIELDS_WEB_CONTENTS_OBSERVER_H_
 
 #include <map>
-#include <set>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "base/containers/flat_map.h"
 #include "base/macros.h"
 #include "base/synchronization/lock.h"
+#include "base/timer/timer.h"
 #include "brave/components/brave_shields/common/brave_shields.mojom.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_receiver_set.h"
@@ -49,6 +50,11 @@ class BraveShieldsWebContentsObserver
   bool IsBlockedSubresource(const std::string& subresource);
   void AddBlockedSubresource(const std::string& subresource);
 
+  // Stats prefs are updated as soon as a request is blocked if |delay| is
+  // zero.
+  static void SetFlushBlockedCountsDelayForTesting(base::TimeDelta delay);
+  static void ResetFlushBlockedCountsDelayForTesting();
+
  protected:
   // content::WebContentsObserver overrides.
   void RenderFrameCreated(content::RenderFrameHost* host) override;
@@ -59,6 +65,7 @@ class BraveShieldsWebContentsObserver
       content::NavigationHandle* navigation_handle) override;
   void DidFinishNavigation(
       content::NavigationHandle* navigation_handle) override;
+  void WebContentsDestroyed() override;
 
   // brave_shields::mojom::BraveShieldsHost.
   void OnJavaScriptBlocked(const std::u16string& details) override;
@@ -75,10 +82,19 @@ class BraveShieldsWebContentsObserver
   mojo::AssociatedRemote<brave_shields::mojom::BraveShields>&
   GetBraveShieldsRemote(content::RenderFrameHost* rfh);
 
+  // Counts a blocked request towards the stats pref |pref_name|. Counts are
+  // added to the profile prefs in batches, so that pages which block hundreds
+  // of requests a second don't write prefs for each of them.
+  void IncrementBlockedCount(const std::string& pref_name);
+  void FlushBlockedCounts();
+
   std::vector<std::string> allowed_script_origins_;
-  // We keep a set of the current page's blocked URLs in case the page
-  // continually tries to load the same blocked URLs.
-  std::set<std::string> blocked_url_paths_;
+  // We keep a set of the hashes of the current page's blocked URLs in case the
+  // page continually tries to load the same blocked URLs.
+  std::unordered_set<size_t> blocked_url_paths_;
+
+  base::flat_map<std::string, uint64_t> pending_blocked_counts_;
+  base::OneShotTimer flush_blocked_counts_timer_;
 
   content::WebContentsFrameReceiverSet<brave_shields::mojom::BraveShieldsHost>
       brave_shields_receivers_;
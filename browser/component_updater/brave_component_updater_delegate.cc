@@ -10,8 +10,10 @@
 #include "base/sequenced_task_runner.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "brave/browser/component_updater/brave_component_installer.h"
 #include "brave/components/brave_component_updater/browser/brave_on_demand_updater.h"
+#include "chrome/browser/after_startup_task_utils.h"
 #include "chrome/browser/browser_process.h"
 #include "components/component_updater/component_updater_service.h"
 
@@ -64,6 +66,12 @@ BraveComponentUpdaterDelegate::GetTaskRunner() {
   return task_runner_;
 }
 
+void BraveComponentUpdaterDelegate::PostAfterStartupTask(
+    base::OnceClosure task) {
+  AfterStartupTaskUtils::PostTask(
+      FROM_HERE, base::SequencedTaskRunnerHandle::Get(), std::move(task));
+}
+
 const std::string BraveComponentUpdaterDelegate::locale() const {
   return g_browser_process->GetApplicationLocale();
 }
@@ -40,6 +40,7 @@ class BraveComponentUpdaterDelegate : public BraveComponent::Delegate {
   void RemoveObserver(ComponentObserver* observer) override;
 
   scoped_refptr<base::SequencedTaskRunner> GetTaskRunner() override;
+  void PostAfterStartupTask(base::OnceClosure task) override;
 
   const std::string locale() const override;
   PrefService* local_state() override;
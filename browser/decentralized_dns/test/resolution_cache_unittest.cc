@@ -0,0 +1,93 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/decentralized_dns/resolution_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "brave/components/decentralized_dns/constants.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace decentralized_dns {
+
+namespace {
+
+constexpr char kIpfsUrl[] =
+    "ipfs://QmWrdNJWMbvRxxzLhojVKaBDswS4KNVM7LvjsN7QbDrvka";
+
+}  // namespace
+
+class ResolutionCacheTest : public testing::Test {
+ public:
+  ResolutionCacheTest() : cache_(base::TimeDelta::FromMinutes(1)) {}
+
+ protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  ResolutionCache cache_;
+};
+
+TEST_F(ResolutionCacheTest, CoalescesPendingRequests) {
+  std::vector<std::string> results;
+  auto callback =
+      base::BindLambdaForTesting([&](const std::string& new_url_spec) {
+        results.push_back(new_url_spec);
+      });
+
+  EXPECT_TRUE(cache_.AddPendingRequest(Provider::ENS, "brave.eth", callback));
+  EXPECT_FALSE(cache_.AddPendingRequest(Provider::ENS, "brave.eth", callback));
+  // Different provider or name, different lookup.
+  EXPECT_TRUE(cache_.AddPendingRequest(Provider::UNSTOPPABLE_DOMAINS,
+                                       "brave.eth", callback));
+  EXPECT_TRUE(cache_.AddPendingRequest(Provider::ENS, "other.eth", callback));
+
+  cache_.OnResolved(Provider::ENS, "brave.eth", true, kIpfsUrl);
+  EXPECT_EQ(std::vector<std::string>({kIpfsUrl, kIpfsUrl}), results);
+
+  // The lookup is done, so the next request starts a new one.
+  EXPECT_TRUE(cache_.AddPendingRequest(Provider::ENS, "brave.eth", callback));
+}
+
+TEST_F(ResolutionCacheTest, ExpiresEntries) {
+  std::string new_url_spec;
+  EXPECT_FALSE(cache_.Get(Provider::ENS, "brave.eth", &new_url_spec));
+
+  cache_.OnResolved(Provider::ENS, "brave.eth", true, kIpfsUrl);
+  // Names without records are cached too.
+  cache_.OnResolved(Provider::ENS, "empty.eth", true, "");
+  EXPECT_TRUE(cache_.Get(Provider::ENS, "brave.eth", &new_url_spec));
+  EXPECT_EQ(kIpfsUrl, new_url_spec);
+  EXPECT_TRUE(cache_.Get(Provider::ENS, "empty.eth", &new_url_spec));
+  EXPECT_EQ("", new_url_spec);
+  EXPECT_FALSE(
+      cache_.Get(Provider::UNSTOPPABLE_DOMAINS, "brave.eth", &new_url_spec));
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(59));
+  EXPECT_TRUE(cache_.Get(Provider::ENS, "brave.eth", &new_url_spec));
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(1));
+  EXPECT_FALSE(cache_.Get(Provider::ENS, "brave.eth", &new_url_spec));
+}
+
+TEST_F(ResolutionCacheTest, DoesNotCacheFailures) {
+  std::string result = "unset";
+  EXPECT_TRUE(cache_.AddPendingRequest(
+      Provider::UNSTOPPABLE_DOMAINS, "brave.crypto",
+      base::BindLambdaForTesting(
+          [&](const std::string& new_url_spec) { result = new_url_spec; })));
+
+  cache_.OnResolved(Provider::UNSTOPPABLE_DOMAINS, "brave.crypto", false,
+                    kIpfsUrl);
+  EXPECT_EQ("", result);
+
+  std::string new_url_spec;
+  EXPECT_FALSE(
+      cache_.Get(Provider::UNSTOPPABLE_DOMAINS, "brave.crypto", &new_url_spec));
+}
+
+}  // namespace decentralized_dns
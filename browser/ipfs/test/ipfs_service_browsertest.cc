@@ -220,6 +220,24 @@ class IpfsServiceBrowserTest : public InProcessBrowserTest {
     return nullptr;
   }
 
+  std::unique_ptr<net::test_server::HttpResponse> HandleImportStepFail(
+      const std::string& failing_path,
+      const std::string& expected_response,
+      const net::test_server::HttpRequest& request) {
+    const GURL gurl = request.GetURL();
+    if (gurl.path_piece() == failing_path) {
+      auto http_response =
+          std::make_unique<net::test_server::BasicHttpResponse>();
+      http_response->set_code(net::HTTP_INTERNAL_SERVER_ERROR);
+      return http_response;
+    }
+    // Nothing is published before the target directory exists.
+    if (failing_path == kImportMakeDirectoryPath &&
+        gurl.path_piece() == kAPIPublishNameEndpoint)
+      ADD_FAILURE() << "Unexpected publish request";
+    return HandleImportRequests(expected_response, request);
+  }
+
   std::unique_ptr<net::test_server::HttpResponse> HandlePreWarmRequest(
       const net::test_server::HttpRequest& request) {
     auto http_response =
@@ -566,6 +584,16 @@ class IpfsServiceBrowserTest : public InProcessBrowserTest {
     }
   }
 
+  void OnImportCompletedWithState(ipfs::ImportState expected,
+                                  const ipfs::ImportedData& data) {
+    EXPECT_FALSE(data.hash.empty());
+    ASSERT_TRUE(data.directory.empty());
+    ASSERT_EQ(data.state, expected);
+    if (wait_for_request_) {
+      wait_for_request_->Quit();
+    }
+  }
+
   void OnGarbageCollectionFail(bool success, const std::string& error) {
     if (wait_for_request_) {
       wait_for_request_->Quit();
@@ -1079,6 +1107,55 @@ IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, ImportFileAndPinToIpfsSuccess) {
   WaitForRequest();
 }
 
+IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, ImportFileToIpfsMkdirFail) {
+  std::string expected_response =
+      R"({"Name":"adbanner.js", "Size":"567857", "Hash": "QmYbK4SLa"})";
+  ResetTestServer(base::BindRepeating(
+      &IpfsServiceBrowserTest::HandleImportStepFail, base::Unretained(this),
+      kImportMakeDirectoryPath, expected_response));
+  auto file_to_upload = embedded_test_server()->GetFullPathFromSourceDirectory(
+      base::FilePath(FILE_PATH_LITERAL("brave/test/data/adbanner.js")));
+  ipfs_service()->ImportFileToIpfs(
+      file_to_upload, std::string("test_key"),
+      base::BindOnce(&IpfsServiceBrowserTest::OnImportCompletedWithState,
+                     base::Unretained(this),
+                     ipfs::IPFS_IMPORT_ERROR_MKDIR_FAILED));
+  WaitForRequest();
+}
+
+IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, ImportFileToIpfsMoveFail) {
+  std::string expected_response =
+      R"({"Name":"adbanner.js", "Size":"567857", "Hash": "QmYbK4SLa"})";
+  ResetTestServer(base::BindRepeating(
+      &IpfsServiceBrowserTest::HandleImportStepFail, base::Unretained(this),
+      kImportCopyPath, expected_response));
+  auto file_to_upload = embedded_test_server()->GetFullPathFromSourceDirectory(
+      base::FilePath(FILE_PATH_LITERAL("brave/test/data/adbanner.js")));
+  ipfs_service()->ImportFileToIpfs(
+      file_to_upload, std::string(),
+      base::BindOnce(&IpfsServiceBrowserTest::OnImportCompletedWithState,
+                     base::Unretained(this),
+                     ipfs::IPFS_IMPORT_ERROR_MOVE_FAILED));
+  WaitForRequest();
+}
+
+// Content imported twice on the same day can't be copied again, but it is
+// still published.
+IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, ImportFileAndPinToIpfsMoveFail) {
+  std::string expected_response =
+      R"({"Name":"adbanner.js", "Size":"567857", "Hash": "QmYbK4SLa"})";
+  ResetTestServer(base::BindRepeating(
+      &IpfsServiceBrowserTest::HandleImportStepFail, base::Unretained(this),
+      kImportCopyPath, expected_response));
+  auto file_to_upload = embedded_test_server()->GetFullPathFromSourceDirectory(
+      base::FilePath(FILE_PATH_LITERAL("brave/test/data/adbanner.js")));
+  ipfs_service()->ImportFileToIpfs(
+      file_to_upload, std::string("test_key"),
+      base::BindOnce(&IpfsServiceBrowserTest::OnPublishCompletedSuccess,
+                     base::Unretained(this)));
+  WaitForRequest();
+}
+
 IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, UpdaterRegistration) {
   base::FilePath user_dir = base::FilePath(FILE_PATH_LITERAL("test"));
   auto* context = browser()->profile();
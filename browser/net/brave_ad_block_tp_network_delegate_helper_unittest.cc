@@ -57,6 +57,9 @@ class TestingBraveComponentUpdaterDelegate : public BraveComponent::Delegate {
   scoped_refptr<base::SequencedTaskRunner> GetTaskRunner() override {
     return base::ThreadTaskRunnerHandle::Get();
   }
+  void PostAfterStartupTask(base::OnceClosure task) override {
+    std::move(task).Run();
+  }
 
   const std::string locale() const override { return "en"; }
   PrefService* local_state() override {
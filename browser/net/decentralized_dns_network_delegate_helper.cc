@@ -5,8 +5,11 @@
 
 #include "brave/browser/net/decentralized_dns_network_delegate_helper.h"
 
+#include <utility>
 #include <vector>
 
+#include "base/bind.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "net/base/net_errors.h"
 
 #include "brave/browser/brave_wallet/brave_wallet_service_factory.h"
@@ -14,6 +17,7 @@
 #include "brave/components/brave_wallet/browser/brave_wallet_utils.h"
 #include "brave/components/brave_wallet/browser/eth_json_rpc_controller.h"
 #include "brave/components/decentralized_dns/constants.h"
+#include "brave/components/decentralized_dns/resolution_cache.h"
 #include "brave/components/decentralized_dns/utils.h"
 #include "brave/components/ipfs/ipfs_utils.h"
 #include "chrome/browser/browser_process.h"
@@ -27,6 +31,83 @@ std::string GetValue(const std::vector<std::string>& arr, RecordKeys key) {
   return arr[static_cast<size_t>(key)];
 }
 
+// Returns the redirect target for an eth_call result of the Unstoppable
+// Domains ProxyReader getMany method, or an empty string if there is none.
+std::string GetUnstoppableDomainsRedirectSpec(const std::string& result) {
+  std::vector<std::string> output;
+  size_t offset = 2 /* len of "0x" */ + 64 /* len of offset to array */;
+  if (offset > result.size() ||
+      !brave_wallet::DecodeStringArray(result.substr(offset), &output)) {
+    return std::string();
+  }
+
+  // Redirect to ipfs URI if content hash is set, otherwise, fallback to the
+  // set redirect URL. If no records available to use, do nothing. See
+  // https://docs.unstoppabledomains.com/browser-resolution/browser-resolution-algorithm
+  // for more details.
+  //
+  // TODO(jocelyn): Do not fallback to the set redirect URL if dns.A or
+  // dns.AAAA is not empty once we support the classical DNS records case.
+  std::string ipfs_uri = GetValue(output, RecordKeys::DWEB_IPFS_HASH);
+  if (ipfs_uri.empty()) {  // Try legacy value.
+    ipfs_uri = GetValue(output, RecordKeys::IPFS_HTML_VALUE);
+  }
+
+  std::string fallback_url = GetValue(output, RecordKeys::BROWSER_REDIRECT_URL);
+  if (fallback_url.empty()) {  // Try legacy value.
+    fallback_url = GetValue(output, RecordKeys::IPFS_REDIRECT_DOMAIN_VALUE);
+  }
+
+  if (!ipfs_uri.empty())
+    return GURL("ipfs://" + ipfs_uri).spec();
+  if (!fallback_url.empty())
+    return GURL(fallback_url).spec();
+  return std::string();
+}
+
+// Returns the redirect target for an eth_call result of the ENS resolver
+// contenthash method, or an empty string if there is none.
+std::string GetEnsRedirectSpec(const std::string& result) {
+  size_t offset = 2 /* len of "0x" */ + 64 /* len of offset to array */;
+  std::string contenthash;
+  if (offset > result.size() ||
+      !brave_wallet::DecodeString(offset, result, &contenthash)) {
+    return std::string();
+  }
+
+  GURL ipfs_uri = ipfs::ContentHashToCIDv1URL(contenthash);
+  if (!ipfs_uri.is_valid())
+    return std::string();
+  return ipfs_uri.spec();
+}
+
+void OnNameResolved(base::WeakPtr<ResolutionCache> cache,
+                    Provider provider,
+                    const std::string& name,
+                    bool success,
+                    const std::string& result) {
+  if (!cache)
+    return;
+
+  std::string new_url_spec;
+  if (success) {
+    new_url_spec = provider == Provider::ENS
+                       ? GetEnsRedirectSpec(result)
+                       : GetUnstoppableDomainsRedirectSpec(result);
+  }
+  cache->OnResolved(provider, name, success, new_url_spec);
+}
+
+void OnResolvedRedirectWork(const brave::ResponseCallback& next_callback,
+                            std::shared_ptr<brave::BraveRequestInfo> ctx,
+                            const std::string& new_url_spec) {
+  if (!new_url_spec.empty())
+    ctx->new_url_spec = new_url_spec;
+
+  if (!next_callback.is_null())
+    next_callback.Run();
+}
+
 }  // namespace
 
 int OnBeforeURLRequest_DecentralizedDnsPreRedirectWork(
@@ -37,44 +118,63 @@ int OnBeforeURLRequest_DecentralizedDnsPreRedirectWork(
     return net::OK;
   }
 
+  Provider provider;
   if (IsUnstoppableDomainsTLD(ctx->request_url) &&
       IsUnstoppableDomainsResolveMethodEthereum(
           g_browser_process->local_state())) {
-    auto* service = brave_wallet::BraveWalletServiceFactory::GetForContext(
-        ctx->browser_context);
-    if (!service) {
-      return net::OK;
-    }
-
-    service->rpc_controller()->UnstoppableDomainsProxyReaderGetMany(
-        kProxyReaderContractAddress, ctx->request_url.host(),
-        std::vector<std::string>(std::begin(kRecordKeys),
-                                 std::end(kRecordKeys)),
-        base::BindOnce(&OnBeforeURLRequest_DecentralizedDnsRedirectWork,
-                       next_callback, ctx));
+    provider = Provider::UNSTOPPABLE_DOMAINS;
+  } else if (IsENSTLD(ctx->request_url) &&
+             IsENSResolveMethodEthereum(g_browser_process->local_state())) {
+    provider = Provider::ENS;
+  } else {
+    return net::OK;
+  }
 
-    return net::ERR_IO_PENDING;
+  auto* service = brave_wallet::BraveWalletServiceFactory::GetForContext(
+      ctx->browser_context);
+  if (!service) {
+    return net::OK;
   }
 
-  if (IsENSTLD(ctx->request_url) &&
-      IsENSResolveMethodEthereum(g_browser_process->local_state())) {
-    auto* service = brave_wallet::BraveWalletServiceFactory::GetForContext(
-        ctx->browser_context);
-    if (!service) {
-      return net::OK;
-    }
-
-    service->rpc_controller()->EnsProxyReaderResolveAddress(
-        kEnsRegistryContractAddress, ctx->request_url.host(),
-        std::vector<std::string>(std::begin(kRecordKeys),
-                                 std::end(kRecordKeys)),
-        base::BindOnce(&OnBeforeURLRequest_EnsRedirectWork, next_callback,
-                       ctx));
+  // Every request to the domain, including subresources, ends up here, so
+  // reuse the resolution of earlier requests when possible.
+  const std::string name = ctx->request_url.host();
+  auto* cache = ResolutionCache::GetForContext(ctx->browser_context);
+  std::string new_url_spec;
+  if (cache->Get(provider, name, &new_url_spec)) {
+    if (!new_url_spec.empty())
+      ctx->new_url_spec = new_url_spec;
+    return net::OK;
+  }
 
+  if (!cache->AddPendingRequest(
+          provider, name,
+          base::BindOnce(&OnResolvedRedirectWork, next_callback, ctx))) {
+    // A lookup for this name is already in flight.
     return net::ERR_IO_PENDING;
   }
 
-  return net::OK;
+  const std::vector<std::string> record_keys(std::begin(kRecordKeys),
+                                             std::end(kRecordKeys));
+  auto callback =
+      base::BindOnce(&OnNameResolved, cache->AsWeakPtr(), provider, name);
+  bool started;
+  if (provider == Provider::UNSTOPPABLE_DOMAINS) {
+    started = service->rpc_controller()->UnstoppableDomainsProxyReaderGetMany(
+        kProxyReaderContractAddress, name, record_keys, std::move(callback));
+  } else {
+    started = service->rpc_controller()->EnsProxyReaderResolveAddress(
+        kEnsRegistryContractAddress, name, record_keys, std::move(callback));
+  }
+  if (!started) {
+    // The callback was dropped, release the queued requests asynchronously.
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&ResolutionCache::OnResolved,
+                                  cache->AsWeakPtr(), provider, name, false,
+                                  std::string()));
+  }
+
+  return net::ERR_IO_PENDING;
 }
 
 void OnBeforeURLRequest_EnsRedirectWork(
@@ -82,27 +182,8 @@ void OnBeforeURLRequest_EnsRedirectWork(
     std::shared_ptr<brave::BraveRequestInfo> ctx,
     bool success,
     const std::string& result) {
-  if (!success) {
-    if (!next_callback.is_null())
-      next_callback.Run();
-    return;
-  }
-  size_t offset = 2 /* len of "0x" */ + 64 /* len of offset to array */;
-  std::string contenthash;
-  if (offset > result.size() ||
-      !brave_wallet::DecodeString(offset, result, &contenthash)) {
-    if (!next_callback.is_null())
-      next_callback.Run();
-    return;
-  }
-
-  GURL ipfs_uri = ipfs::ContentHashToCIDv1URL(contenthash);
-  if (ipfs_uri.is_valid()) {
-    ctx->new_url_spec = ipfs_uri.spec();
-  }
-
-  if (!next_callback.is_null())
-    next_callback.Run();
+  OnResolvedRedirectWork(next_callback, ctx,
+                         success ? GetEnsRedirectSpec(result) : std::string());
 }
 
 void OnBeforeURLRequest_DecentralizedDnsRedirectWork(
@@ -110,46 +191,9 @@ void OnBeforeURLRequest_DecentralizedDnsRedirectWork(
     std::shared_ptr<brave::BraveRequestInfo> ctx,
     bool success,
     const std::string& result) {
-  if (!success) {
-    if (!next_callback.is_null())
-      next_callback.Run();
-    return;
-  }
-
-  std::vector<std::string> output;
-  size_t offset = 2 /* len of "0x" */ + 64 /* len of offset to array */;
-  if (offset > result.size() ||
-      !brave_wallet::DecodeStringArray(result.substr(offset), &output)) {
-    if (!next_callback.is_null())
-      next_callback.Run();
-    return;
-  }
-
-  // Redirect to ipfs URI if content hash is set, otherwise, fallback to the
-  // set redirect URL. If no records available to use, do nothing. See
-  // https://docs.unstoppabledomains.com/browser-resolution/browser-resolution-algorithm
-  // for more details.
-  //
-  // TODO(jocelyn): Do not fallback to the set redirect URL if dns.A or
-  // dns.AAAA is not empty once we support the classical DNS records case.
-  std::string ipfs_uri = GetValue(output, RecordKeys::DWEB_IPFS_HASH);
-  if (ipfs_uri.empty()) {  // Try legacy value.
-    ipfs_uri = GetValue(output, RecordKeys::IPFS_HTML_VALUE);
-  }
-
-  std::string fallback_url = GetValue(output, RecordKeys::BROWSER_REDIRECT_URL);
-  if (fallback_url.empty()) {  // Try legacy value.
-    fallback_url = GetValue(output, RecordKeys::IPFS_REDIRECT_DOMAIN_VALUE);
-  }
-
-  if (!ipfs_uri.empty()) {
-    ctx->new_url_spec = GURL("ipfs://" + ipfs_uri).spec();
-  } else if (!fallback_url.empty()) {
-    ctx->new_url_spec = GURL(fallback_url).spec();
-  }
-
-  if (!next_callback.is_null())
-    next_callback.Run();
+  OnResolvedRedirectWork(
+      next_callback, ctx,
+      success ? GetUnstoppableDomainsRedirectSpec(result) : std::string());
 }
 
 }  // namespace decentralized_dns
@@ -6,9 +6,14 @@
 #include "brave/browser/net/decentralized_dns_network_delegate_helper.h"
 
 #include <memory>
+#include <vector>
 
+#include "base/run_loop.h"
+#include "base/test/bind.h"
 #include "base/test/scoped_feature_list.h"
+#include "brave/browser/brave_wallet/brave_wallet_service_factory.h"
 #include "brave/browser/net/url_context.h"
+#include "brave/components/brave_wallet/browser/brave_wallet_service.h"
 #include "brave/components/decentralized_dns/constants.h"
 #include "brave/components/decentralized_dns/features.h"
 #include "brave/components/decentralized_dns/pref_names.h"
@@ -17,8 +22,11 @@
 #include "chrome/test/base/testing_browser_process.h"
 #include "chrome/test/base/testing_profile.h"
 #include "components/prefs/testing_pref_service.h"
+#include "components/user_prefs/user_prefs.h"
 #include "content/public/test/browser_task_environment.h"
 #include "net/base/net_errors.h"
+#include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
+#include "services/network/test/test_url_loader_factory.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "url/gurl.h"
 
@@ -26,6 +34,46 @@ using brave::ResponseCallback;
 
 namespace decentralized_dns {
 
+namespace {
+
+// getMany result with both an IPFS URI and fallback URLs set.
+constexpr char kGetManyResult[] =
+    // offset for array
+    "0x0000000000000000000000000000000000000000000000000000000000000020"
+    // count for array
+    "0000000000000000000000000000000000000000000000000000000000000006"
+    // offsets for array elements
+    "00000000000000000000000000000000000000000000000000000000000000c0"
+    "0000000000000000000000000000000000000000000000000000000000000120"
+    "0000000000000000000000000000000000000000000000000000000000000180"
+    "00000000000000000000000000000000000000000000000000000000000001a0"
+    "00000000000000000000000000000000000000000000000000000000000001c0"
+    "0000000000000000000000000000000000000000000000000000000000000200"
+    // count for "QmWrdNJWMbvRxxzLhojVKaBDswS4KNVM7LvjsN7QbDrvka"
+    "000000000000000000000000000000000000000000000000000000000000002e"
+    // encoding for "QmWrdNJWMbvRxxzLhojVKaBDswS4KNVM7LvjsN7QbDrvka"
+    "516d5772644e4a574d62765278787a4c686f6a564b614244737753344b4e564d"
+    "374c766a734e3751624472766b61000000000000000000000000000000000000"
+    // count for "QmbWqxBEKC3P8tqsKc98xmWNzrzDtRLMiMPL8wBuTGsMnR"
+    "000000000000000000000000000000000000000000000000000000000000002e"
+    // encoding for "QmbWqxBEKC3P8tqsKc98xmWNzrzDtRLMiMPL8wBuTGsMnR"
+    "516d6257717842454b433350387471734b633938786d574e7a727a4474524c4d"
+    "694d504c387742755447734d6e52000000000000000000000000000000000000"
+    // count for empty dns.A
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    // count for empty dns.AAAA
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    // count for "https://fallback1.test.com"
+    "000000000000000000000000000000000000000000000000000000000000001a"
+    // encoding for "https://fallback1.test.com"
+    "68747470733a2f2f66616c6c6261636b312e746573742e636f6d000000000000"
+    // count for "https://fallback2.test.com"
+    "000000000000000000000000000000000000000000000000000000000000001a"
+    // encoding for "https://fallback2.test.com"
+    "68747470733a2f2f66616c6c6261636b322e746573742e636f6d000000000000";
+
+}  // namespace
+
 class DecentralizedDnsNetworkDelegateHelperTest : public testing::Test {
  public:
   DecentralizedDnsNetworkDelegateHelperTest()
@@ -301,4 +349,66 @@ TEST_F(DecentralizedDnsNetworkDelegateHelperTest, EnsRedirectWork) {
       "ipns://bafybeihqoo7bq7uoaybzpfwegks33vw2h5adyl4t7joz3pofkr6h7yhdxq");
 }
 
+TEST_F(DecentralizedDnsNetworkDelegateHelperTest, ResolvesNameOncePerPage) {
+  local_state()->SetInteger(kUnstoppableDomainsResolveMethod,
+                            static_cast<int>(ResolveMethodTypes::ETHEREUM));
+
+  // Fake Ethereum provider answering every eth_call with the same records.
+  network::TestURLLoaderFactory url_loader_factory;
+  int rpc_calls = 0;
+  url_loader_factory.SetInterceptor(
+      base::BindLambdaForTesting([&](const network::ResourceRequest& request) {
+        rpc_calls++;
+        url_loader_factory.AddResponse(
+            request.url.spec(),
+            std::string("{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":\"") +
+                kGetManyResult + "\"}");
+      }));
+  brave_wallet::BraveWalletServiceFactory::GetInstance()
+      ->SetTestingFactoryAndUse(
+          profile(),
+          base::BindLambdaForTesting([&](content::BrowserContext* context)
+                                         -> std::unique_ptr<KeyedService> {
+            return std::make_unique<brave_wallet::BraveWalletService>(
+                user_prefs::UserPrefs::Get(context),
+                base::MakeRefCounted<
+                    network::WeakWrapperSharedURLLoaderFactory>(
+                    &url_loader_factory));
+          }));
+
+  // A page and its subresources, all requested before the name resolves.
+  const char* const urls[] = {
+      "http://brave.crypto/", "http://brave.crypto/style.css",
+      "http://brave.crypto/script.js", "http://brave.crypto/image.png"};
+  std::vector<std::shared_ptr<brave::BraveRequestInfo>> requests;
+  int completed = 0;
+  for (const char* url : urls) {
+    auto request = std::make_shared<brave::BraveRequestInfo>(GURL(url));
+    request->browser_context = profile();
+    EXPECT_EQ(net::ERR_IO_PENDING,
+              OnBeforeURLRequest_DecentralizedDnsPreRedirectWork(
+                  base::BindLambdaForTesting([&]() { completed++; }),
+                  request));
+    requests.push_back(request);
+  }
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(1, rpc_calls);
+  EXPECT_EQ(4, completed);
+  for (const auto& request : requests) {
+    EXPECT_EQ("ipfs://QmWrdNJWMbvRxxzLhojVKaBDswS4KNVM7LvjsN7QbDrvka",
+              request->new_url_spec);
+  }
+
+  // Later requests are redirected synchronously.
+  auto request =
+      std::make_shared<brave::BraveRequestInfo>(GURL("http://brave.crypto/a"));
+  request->browser_context = profile();
+  EXPECT_EQ(net::OK, OnBeforeURLRequest_DecentralizedDnsPreRedirectWork(
+                         ResponseCallback(), request));
+  EXPECT_EQ("ipfs://QmWrdNJWMbvRxxzLhojVKaBDswS4KNVM7LvjsN7QbDrvka",
+            request->new_url_spec);
+  EXPECT_EQ(1, rpc_calls);
+}
+
 }  // namespace decentralized_dns
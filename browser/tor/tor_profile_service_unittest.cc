@@ -0,0 +1,102 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+
+#include "brave/browser/tor/tor_profile_manager.h"
+#include "brave/browser/tor/tor_profile_service_factory.h"
+#include "brave/components/tor/mock_tor_launcher_factory.h"
+#include "brave/components/tor/tor_profile_service.h"
+#include "chrome/test/base/testing_browser_process.h"
+#include "chrome/test/base/testing_profile.h"
+#include "chrome/test/base/testing_profile_manager.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace tor {
+namespace {
+constexpr char kTestProfileName[] = "TestProfile";
+}  // namespace
+
+class TorProfileServiceUnitTest : public testing::Test {
+ public:
+  TorProfileServiceUnitTest() = default;
+  ~TorProfileServiceUnitTest() override = default;
+
+  void SetUp() override {
+    TestingBrowserProcess* browser_process = TestingBrowserProcess::GetGlobal();
+    profile_manager_.reset(new TestingProfileManager(browser_process));
+    ASSERT_TRUE(profile_manager_->SetUp());
+    Profile* profile = profile_manager_->CreateTestingProfile(kTestProfileName);
+    Profile* tor_profile =
+        TorProfileManager::GetInstance().GetTorProfile(profile);
+    tor_profile_service_ = TorProfileServiceFactory::GetForContext(tor_profile);
+    ASSERT_TRUE(tor_profile_service_);
+    tor_profile_service_->SetTorLauncherFactoryForTest(GetTorLauncherFactory());
+  }
+
+  void TearDown() override {
+    testing::Mock::VerifyAndClearExpectations(GetTorLauncherFactory());
+    profile_manager_->DeleteTestingProfile(kTestProfileName);
+  }
+
+  TorProfileService* tor_profile_service() { return tor_profile_service_; }
+
+  MockTorLauncherFactory* GetTorLauncherFactory() {
+    return &MockTorLauncherFactory::GetInstance();
+  }
+
+ protected:
+  content::BrowserTaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+
+ private:
+  TorProfileService* tor_profile_service_ = nullptr;
+  std::unique_ptr<TestingProfileManager> profile_manager_;
+
+  TorProfileServiceUnitTest(const TorProfileServiceUnitTest&) = delete;
+  TorProfileServiceUnitTest& operator=(const TorProfileServiceUnitTest&) =
+      delete;
+};
+
+TEST_F(TorProfileServiceUnitTest, PrewarmsOncePerIsolationKey) {
+  testing::Mock::AllowLeak(GetTorLauncherFactory());
+  EXPECT_CALL(*GetTorLauncherFactory(), PrewarmCircuit).Times(2);
+
+  tor_profile_service()->PrewarmCircuitForURL(GURL("https://example.com/"));
+  // Same circuit isolation key as above.
+  tor_profile_service()->PrewarmCircuitForURL(
+      GURL("https://example.com/search?q=tor"));
+  tor_profile_service()->PrewarmCircuitForURL(
+      GURL("https://www.example.com/"));
+  tor_profile_service()->PrewarmCircuitForURL(GURL("https://example.org/"));
+}
+
+TEST_F(TorProfileServiceUnitTest, PrewarmsAgainAfterInterval) {
+  testing::Mock::AllowLeak(GetTorLauncherFactory());
+  EXPECT_CALL(*GetTorLauncherFactory(), PrewarmCircuit).Times(1);
+  tor_profile_service()->PrewarmCircuitForURL(GURL("https://example.com/"));
+  task_environment_.FastForwardBy(base::TimeDelta::FromMinutes(9));
+  tor_profile_service()->PrewarmCircuitForURL(GURL("https://example.com/"));
+  testing::Mock::VerifyAndClearExpectations(GetTorLauncherFactory());
+
+  EXPECT_CALL(*GetTorLauncherFactory(), PrewarmCircuit).Times(1);
+  task_environment_.FastForwardBy(base::TimeDelta::FromMinutes(1));
+  tor_profile_service()->PrewarmCircuitForURL(GURL("https://example.com/"));
+}
+
+TEST_F(TorProfileServiceUnitTest, SkipsUnsupportedURLs) {
+  testing::Mock::AllowLeak(GetTorLauncherFactory());
+  EXPECT_CALL(*GetTorLauncherFactory(), PrewarmCircuit).Times(0);
+
+  // Onion services use rendezvous circuits.
+  tor_profile_service()->PrewarmCircuitForURL(GURL(
+      "https://duckduckgogg42xjoc72x3sjasowoarfbgcmvfimaftt6twagswzczad.onion/"));
+  tor_profile_service()->PrewarmCircuitForURL(GURL("ftp://example.com/"));
+  tor_profile_service()->PrewarmCircuitForURL(GURL("chrome://settings"));
+}
+
+}  // namespace tor
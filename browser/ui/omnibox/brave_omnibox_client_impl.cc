@@ -12,6 +12,7 @@
 #include "base/values.h"
 #include "brave/browser/autocomplete/brave_autocomplete_scheme_classifier.h"
 #include "brave/common/pref_names.h"
+#include "brave/components/tor/buildflags/buildflags.h"
 #include "brave/components/weekly_storage/weekly_storage.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/ui/omnibox/chrome_omnibox_client.h"
@@ -20,6 +21,12 @@
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
 
+#if BUILDFLAG(ENABLE_TOR)
+#include "brave/browser/tor/tor_profile_service_factory.h"
+#include "brave/components/tor/tor_profile_service.h"
+#include "components/omnibox/browser/autocomplete_result.h"
+#endif
+
 namespace {
 
 constexpr char kSearchCountPrefName[] = "brave.weekly_storage.search_count";
@@ -90,3 +97,24 @@ void BraveOmniboxClientImpl::OnInputAccepted(const AutocompleteMatch& match) {
     RecordSearchEventP3A(storage.GetWeeklySum());
   }
 }
+
+void BraveOmniboxClientImpl::OnResultChanged(
+    const AutocompleteResult& result,
+    bool default_match_changed,
+    const BitmapFetchedCallback& on_bitmap_fetched) {
+  ChromeOmniboxClient::OnResultChanged(result, default_match_changed,
+                                       on_bitmap_fetched);
+#if BUILDFLAG(ENABLE_TOR)
+  // Build a circuit for the site the user is most likely going to open while
+  // they are still typing.
+  if (!default_match_changed || !profile_->IsTor())
+    return;
+  const AutocompleteMatch* default_match = result.default_match();
+  if (!default_match)
+    return;
+  if (tor::TorProfileService* service =
+          TorProfileServiceFactory::GetForContext(profile_)) {
+    service->PrewarmCircuitForURL(default_match->destination_url);
+  }
+#endif
+}
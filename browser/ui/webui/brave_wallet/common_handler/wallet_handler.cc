@@ -71,8 +71,7 @@ void WalletHandler::UnlockWallet(const std::string& password,
   auto* profile = Profile::FromWebUI(web_ui_);
   auto* keyring_controller =
       GetBraveWalletService(profile)->keyring_controller();
-  bool result = keyring_controller->Unlock(password);
-  std::move(callback).Run(result);
+  keyring_controller->Unlock(password, std::move(callback));
 }
 
 void WalletHandler::AddFavoriteApp(
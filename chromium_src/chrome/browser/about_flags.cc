@@ -62,7 +62,12 @@ using ntp_background_images::features::kBraveNTPSuperReferralWallpaper;
     {"speedreader-legacy-backend",                                      \
      flag_descriptions::kBraveSpeedreaderLegacyName,                    \
      flag_descriptions::kBraveSpeedreaderLegacyDescription, kOsDesktop, \
-     FEATURE_VALUE_TYPE(speedreader::kSpeedreaderLegacyBackend)},
+     FEATURE_VALUE_TYPE(speedreader::kSpeedreaderLegacyBackend)},       \
+    {"speedreader-streaming-rewrite",                                   \
+     flag_descriptions::kBraveSpeedreaderStreamingName,                 \
+     flag_descriptions::kBraveSpeedreaderStreamingDescription,          \
+     kOsDesktop,                                                        \
+     FEATURE_VALUE_TYPE(speedreader::kSpeedreaderStreamingRewrite)},
 #else
 #define SPEEDREADER_FEATURE_ENTRIES
 #endif
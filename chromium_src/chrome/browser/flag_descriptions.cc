@@ -54,6 +54,11 @@ const char kBraveSpeedreaderLegacyName[] =
 const char kBraveSpeedreaderLegacyDescription[] =
     "Enables the legacy backend for SpeedReader. Uses adblock rules to "
     "determine if pages are readable and distills using CSS selector rules.";
+const char kBraveSpeedreaderStreamingName[] =
+    "Enable streaming rewriting for SpeedReader";
+const char kBraveSpeedreaderStreamingDescription[] =
+    "Feeds the page to SpeedReader as it is downloaded and sends distilled "
+    "output as soon as it is available instead of buffering the whole page.";
 const char kBraveSyncName[] = "Enable Brave Sync v2";
 const char kBraveSyncDescription[] =
     "Brave Sync v2 integrates with chromium sync engine with Brave specific "
@@ -33,6 +33,8 @@ extern const char kBraveSpeedreaderName[];
 extern const char kBraveSpeedreaderDescription[];
 extern const char kBraveSpeedreaderLegacyName[];
 extern const char kBraveSpeedreaderLegacyDescription[];
+extern const char kBraveSpeedreaderStreamingName[];
+extern const char kBraveSpeedreaderStreamingDescription[];
 extern const char kBraveSyncName[];
 extern const char kBraveSyncDescription[];
 extern const char kBraveIpfsName[];
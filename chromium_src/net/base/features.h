@@ -16,6 +16,7 @@ NET_EXPORT extern const base::Feature kBraveEphemeralStorage;
 NET_EXPORT extern const base::Feature kBraveEphemeralStorageKeepAlive;
 NET_EXPORT extern const base::FeatureParam<int>
     kBraveEphemeralStorageKeepAliveTimeInSeconds;
+NET_EXPORT extern const base::Feature kBraveSocks5OptimisticHandshake;
 
 }  // namespace features
 }  // namespace net
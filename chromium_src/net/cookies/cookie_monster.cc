@@ -6,6 +6,8 @@
 #include "net/cookies/cookie_monster.h"
 
 #include <memory>
+#include <utility>
+
 #include "net/base/url_util.h"
 
 #define CookieMonster ChromiumCookieMonster
@@ -29,6 +31,13 @@ CookieMonster::CookieMonster(scoped_refptr<PersistentCookieStore> store,
 
 CookieMonster::~CookieMonster() {}
 
+ChromiumCookieMonster* CookieMonster::GetEphemeralCookieStoreForTopFrameURL(
+    const GURL& top_frame_url) {
+  auto it =
+      ephemeral_cookie_stores_.find(URLToEphemeralStorageDomain(top_frame_url));
+  return it != ephemeral_cookie_stores_.end() ? it->second.get() : nullptr;
+}
+
 ChromiumCookieMonster*
 CookieMonster::GetOrCreateEphemeralCookieStoreForTopFrameURL(
     const GURL& top_frame_url) {
@@ -37,9 +46,13 @@ CookieMonster::GetOrCreateEphemeralCookieStoreForTopFrameURL(
   if (it != ephemeral_cookie_stores_.end())
     return it->second.get();
 
-  return ephemeral_cookie_stores_
-      .emplace(domain, new ChromiumCookieMonster(nullptr /* store */,
-                                                 net_log_.net_log()))
+  auto ephemeral_monster = std::make_unique<ChromiumCookieMonster>(
+      nullptr /* store */, net_log_.net_log());
+  if (cookieable_schemes_) {
+    ephemeral_monster->SetCookieableSchemes(*cookieable_schemes_,
+                                            SetCookieableSchemesCallback());
+  }
+  return ephemeral_cookie_stores_.emplace(domain, std::move(ephemeral_monster))
       .first->second.get();
 }
 
@@ -88,6 +101,7 @@ void CookieMonster::DeleteSessionCookiesAsync(DeleteCallback callback) {
 void CookieMonster::SetCookieableSchemes(
     const std::vector<std::string>& schemes,
     SetCookieableSchemesCallback callback) {
+  cookieable_schemes_ = schemes;
   for (auto& it : ephemeral_cookie_stores_) {
     it.second->SetCookieableSchemes(schemes, SetCookieableSchemesCallback());
   }
@@ -100,7 +114,13 @@ void CookieMonster::GetEphemeralCookieListWithOptionsAsync(
     const CookieOptions& options,
     GetCookieListCallback callback) {
   ChromiumCookieMonster* ephemeral_monster =
-      GetOrCreateEphemeralCookieStoreForTopFrameURL(top_frame_url);
+      GetEphemeralCookieStoreForTopFrameURL(top_frame_url);
+  if (!ephemeral_monster) {
+    // Nothing was ever set in this partition. An empty in-memory monster
+    // would also answer synchronously, with no included or excluded cookies.
+    std::move(callback).Run({}, {});
+    return;
+  }
   ephemeral_monster->GetCookieListWithOptionsAsync(url, options,
                                                    std::move(callback));
 }
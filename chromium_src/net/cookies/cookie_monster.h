@@ -6,6 +6,8 @@
 #ifndef BRAVE_CHROMIUM_SRC_NET_COOKIES_COOKIE_MONSTER_H_
 #define BRAVE_CHROMIUM_SRC_NET_COOKIES_COOKIE_MONSTER_H_
 
+#include "base/optional.h"
+
 #define CookieMonster ChromiumCookieMonster
 #include "../../../../net/cookies/cookie_monster.h"
 #undef CookieMonster
@@ -48,11 +50,20 @@ class NET_EXPORT CookieMonster : public ChromiumCookieMonster {
                                         SetCookiesCallback callback);
 
  private:
+  // Returns the ephemeral store for |top_frame_url| or nullptr if nothing was
+  // ever written to it, so reads don't allocate a monster per visited site.
+  ChromiumCookieMonster* GetEphemeralCookieStoreForTopFrameURL(
+      const GURL& top_frame_url);
+  ChromiumCookieMonster* GetOrCreateEphemeralCookieStoreForTopFrameURL(
+      const GURL& top_frame_url);
+
   NetLogWithSource net_log_;
+  // Ephemeral stores keyed by ephemeral storage domain, so a whole partition
+  // is dropped at once when its last tab closes.
   std::map<std::string, std::unique_ptr<ChromiumCookieMonster>>
       ephemeral_cookie_stores_;
-  ChromiumCookieMonster* GetOrCreateEphemeralCookieStoreForTopFrameURL(
-      const GURL& top_frame_url);
+  // Applied to ephemeral stores created after SetCookieableSchemes().
+  base::Optional<std::vector<std::string>> cookieable_schemes_;
 };
 
 }  // namespace net
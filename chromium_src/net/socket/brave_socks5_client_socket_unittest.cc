@@ -0,0 +1,198 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "net/socket/socks5_client_socket.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/test/scoped_feature_list.h"
+#include "net/base/address_list.h"
+#include "net/base/features.h"
+#include "net/base/host_port_pair.h"
+#include "net/base/ip_address.h"
+#include "net/base/test_completion_callback.h"
+#include "net/socket/socket_test_util.h"
+#include "net/test/gtest_util.h"
+#include "net/test/test_with_task_environment.h"
+#include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using net::test::IsError;
+using net::test::IsOk;
+
+namespace net {
+
+namespace {
+
+const char kGreeting[] = {0x05, 0x01, 0x02};
+const char kGreetingReply[] = {0x05, 0x02};
+const char kAuthRequest[] = {0x01, 0x04, 'u', 's', 'e', 'r',
+                             0x04, 'p', 'a', 's', 's'};
+const char kAuthReply[] = {0x01, 0x00};
+const char kBadAuthReply[] = {0x01, 0x01};
+const char kConnectRequest[] = {0x05, 0x01, 0x00, 0x03, 0x0b, 'e', 'x',
+                                'a',  'm',  'p',  'l',  'e',  '.', 'c',
+                                'o',  'm',  0x00, 0x50};
+const char kConnectReply[] = {0x05, 0x00, 0x00, 0x01, 0x7f,
+                              0x00, 0x00, 0x01, 0x00, 0x50};
+
+const uint16_t kProxyPort = 9050;
+
+std::string GetPipelinedRequests() {
+  return std::string(kAuthRequest, sizeof(kAuthRequest)) +
+         std::string(kConnectRequest, sizeof(kConnectRequest));
+}
+
+}  // namespace
+
+class BraveSOCKS5ClientSocketTest : public testing::Test,
+                                    public WithTaskEnvironment {
+ protected:
+  void SetUp() override {
+    feature_list_.InitAndEnableFeature(
+        features::kBraveSocks5OptimisticHandshake);
+  }
+
+  void TearDown() override {
+    SOCKS5ClientSocketAuth::ResetOptimisticHandshakeStateForTesting();
+  }
+
+  int Connect(SocketDataProvider* data) {
+    data->set_connect_data(MockConnect(SYNCHRONOUS, OK));
+    auto transport = std::make_unique<MockTCPClientSocket>(
+        AddressList::CreateFromIPAddress(IPAddress::IPv4Localhost(),
+                                         kProxyPort),
+        nullptr, data);
+    TestCompletionCallback callback;
+    EXPECT_THAT(callback.GetResult(transport->Connect(callback.callback())),
+                IsOk());
+
+    socket_ = std::make_unique<SOCKS5ClientSocketAuth>(
+        std::move(transport), HostPortPair("example.com", 80),
+        TRAFFIC_ANNOTATION_FOR_TESTS,
+        HostPortPair("user", "pass", "127.0.0.1", kProxyPort));
+    return callback.GetResult(socket_->Connect(callback.callback()));
+  }
+
+  // Checks that a new connection doesn't pipeline anymore.
+  void ExpectStepwiseHandshake() {
+    MockWrite writes[] = {
+        MockWrite(SYNCHRONOUS, kGreeting, sizeof(kGreeting)),
+        MockWrite(SYNCHRONOUS, kAuthRequest, sizeof(kAuthRequest)),
+        MockWrite(SYNCHRONOUS, kConnectRequest, sizeof(kConnectRequest)),
+    };
+    MockRead reads[] = {
+        MockRead(SYNCHRONOUS, kGreetingReply, sizeof(kGreetingReply)),
+        MockRead(SYNCHRONOUS, kAuthReply, sizeof(kAuthReply)),
+        MockRead(SYNCHRONOUS, kConnectReply, sizeof(kConnectReply)),
+    };
+    StaticSocketDataProvider data(reads, writes);
+    EXPECT_THAT(Connect(&data), IsOk());
+    EXPECT_TRUE(data.AllReadDataConsumed());
+    EXPECT_TRUE(data.AllWriteDataConsumed());
+  }
+
+  base::test::ScopedFeatureList feature_list_;
+  std::unique_ptr<SOCKS5ClientSocketAuth> socket_;
+};
+
+TEST_F(BraveSOCKS5ClientSocketTest, SendsConnectWithAuth) {
+  const std::string requests = GetPipelinedRequests();
+  MockWrite writes[] = {
+      MockWrite(SYNCHRONOUS, kGreeting, sizeof(kGreeting)),
+      MockWrite(SYNCHRONOUS, requests.data(), requests.size()),
+  };
+  MockRead reads[] = {
+      MockRead(SYNCHRONOUS, kGreetingReply, sizeof(kGreetingReply)),
+      MockRead(SYNCHRONOUS, kAuthReply, sizeof(kAuthReply)),
+      MockRead(SYNCHRONOUS, kConnectReply, sizeof(kConnectReply)),
+  };
+  StaticSocketDataProvider data(reads, writes);
+
+  EXPECT_THAT(Connect(&data), IsOk());
+  EXPECT_TRUE(socket_->IsConnected());
+  EXPECT_TRUE(data.AllReadDataConsumed());
+  EXPECT_TRUE(data.AllWriteDataConsumed());
+}
+
+TEST_F(BraveSOCKS5ClientSocketTest, RetriesStepwiseOnBadAuthReply) {
+  const std::string requests = GetPipelinedRequests();
+  MockWrite writes[] = {
+      MockWrite(SYNCHRONOUS, kGreeting, sizeof(kGreeting)),
+      MockWrite(SYNCHRONOUS, requests.data(), requests.size()),
+      // Same connection attempt, after reconnecting to the proxy.
+      MockWrite(SYNCHRONOUS, kGreeting, sizeof(kGreeting)),
+      MockWrite(SYNCHRONOUS, kAuthRequest, sizeof(kAuthRequest)),
+      MockWrite(SYNCHRONOUS, kConnectRequest, sizeof(kConnectRequest)),
+  };
+  MockRead reads[] = {
+      MockRead(SYNCHRONOUS, kGreetingReply, sizeof(kGreetingReply)),
+      MockRead(SYNCHRONOUS, kBadAuthReply, sizeof(kBadAuthReply)),
+      MockRead(SYNCHRONOUS, kGreetingReply, sizeof(kGreetingReply)),
+      MockRead(SYNCHRONOUS, kAuthReply, sizeof(kAuthReply)),
+      MockRead(SYNCHRONOUS, kConnectReply, sizeof(kConnectReply)),
+  };
+  StaticSocketDataProvider data(reads, writes);
+
+  EXPECT_THAT(Connect(&data), IsOk());
+  EXPECT_TRUE(socket_->IsConnected());
+  EXPECT_TRUE(data.AllReadDataConsumed());
+  EXPECT_TRUE(data.AllWriteDataConsumed());
+
+  ExpectStepwiseHandshake();
+}
+
+TEST_F(BraveSOCKS5ClientSocketTest, RetriesStepwiseWhenProxyHangsUp) {
+  const std::string requests = GetPipelinedRequests();
+  MockWrite writes[] = {
+      MockWrite(SYNCHRONOUS, kGreeting, sizeof(kGreeting)),
+      MockWrite(SYNCHRONOUS, requests.data(), requests.size()),
+      MockWrite(SYNCHRONOUS, kGreeting, sizeof(kGreeting)),
+      MockWrite(SYNCHRONOUS, kAuthRequest, sizeof(kAuthRequest)),
+      MockWrite(SYNCHRONOUS, kConnectRequest, sizeof(kConnectRequest)),
+  };
+  MockRead reads[] = {
+      MockRead(SYNCHRONOUS, kGreetingReply, sizeof(kGreetingReply)),
+      MockRead(SYNCHRONOUS, OK),  // EOF
+      MockRead(SYNCHRONOUS, kGreetingReply, sizeof(kGreetingReply)),
+      MockRead(SYNCHRONOUS, kAuthReply, sizeof(kAuthReply)),
+      MockRead(SYNCHRONOUS, kConnectReply, sizeof(kConnectReply)),
+  };
+  StaticSocketDataProvider data(reads, writes);
+
+  EXPECT_THAT(Connect(&data), IsOk());
+  EXPECT_TRUE(data.AllReadDataConsumed());
+  EXPECT_TRUE(data.AllWriteDataConsumed());
+
+  ExpectStepwiseHandshake();
+}
+
+TEST_F(BraveSOCKS5ClientSocketTest, FailsOnBadAuthReplyWhenStepwise) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndDisableFeature(
+      features::kBraveSocks5OptimisticHandshake);
+
+  MockWrite writes[] = {
+      MockWrite(SYNCHRONOUS, kGreeting, sizeof(kGreeting)),
+      MockWrite(SYNCHRONOUS, kAuthRequest, sizeof(kAuthRequest)),
+  };
+  MockRead reads[] = {
+      MockRead(SYNCHRONOUS, kGreetingReply, sizeof(kGreetingReply)),
+      MockRead(SYNCHRONOUS, kBadAuthReply, sizeof(kBadAuthReply)),
+  };
+  StaticSocketDataProvider data(reads, writes);
+  EXPECT_THAT(Connect(&data), IsError(ERR_FAILED));
+}
+
+TEST_F(BraveSOCKS5ClientSocketTest, StepwiseHandshakeWhenDisabled) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndDisableFeature(
+      features::kBraveSocks5OptimisticHandshake);
+  ExpectStepwiseHandshake();
+}
+
+}  // namespace net
@@ -10,14 +10,37 @@
 #include <string>
 #include <utility>
 
+#include <set>
+
+#include "base/feature_list.h"
+#include "base/no_destructor.h"
+#include "net/base/features.h"
 #include "net/base/io_buffer.h"
 #include "net/socket/socks5_client_socket.h"
 
 namespace net {
 
+namespace {
+
+// Proxies which broke a pipelined handshake, so later connections to them
+// go back to one round-trip per step. Only used on the network thread.
+std::set<std::string>& GetProxiesWithoutOptimisticHandshake() {
+  static base::NoDestructor<std::set<std::string>> proxies;
+  return *proxies;
+}
+
+}  // namespace
+
 int SOCKS5ClientSocket::DoAuth(int rv) {
   rv = Authenticate(rv, net_log_, io_callback_);
-  next_state_ = (rv == OK ? STATE_HANDSHAKE_WRITE : STATE_AUTH);
+  if (rv == ERR_IO_PENDING) {
+    next_state_ = STATE_AUTH;
+    return rv;
+  }
+  // Authenticate() picks the next state itself when it already sent the
+  // CONNECT request or restarts the handshake.
+  if (rv == OK && next_state_ == STATE_NONE)
+    next_state_ = STATE_HANDSHAKE_WRITE;
   return rv;
 }
 
@@ -65,6 +88,35 @@ uint8_t SOCKS5ClientSocketAuth::auth_method() {
 
 static const size_t kSOCKSAuthUsernamePasswordResponseLen = 2;
 
+std::string SOCKS5ClientSocketAuth::BuildAuthRequest() {
+  // 0x01, usernamelen, username, passwordlen, password
+  size_t usernamelen = username().size();
+  size_t passwordlen = password().size();
+  std::string request(1 + 1 + usernamelen + 1 + passwordlen, 0);
+  request[0] = 0x01;
+  request[1] = usernamelen;
+  request.replace(2, usernamelen, username());
+  request[2 + usernamelen] = passwordlen;
+  request.replace(2 + usernamelen + 1, passwordlen, password());
+  DCHECK_EQ(request.size(), 2 + usernamelen + 1 + passwordlen);
+  return request;
+}
+
+// static
+void SOCKS5ClientSocketAuth::ResetOptimisticHandshakeStateForTesting() {
+  GetProxiesWithoutOptimisticHandshake().clear();
+}
+
+bool SOCKS5ClientSocketAuth::ShouldSendConnectWithAuth() {
+  // Tor, the main user of authenticated SOCKS5, reads the CONNECT request
+  // right after the auth request, so it doesn't have to wait for the auth
+  // reply. This saves a round-trip on every new circuit.
+  return base::FeatureList::IsEnabled(
+             features::kBraveSocks5OptimisticHandshake) &&
+         !GetProxiesWithoutOptimisticHandshake().count(
+             proxy_host_port_.ToString());
+}
+
 int SOCKS5ClientSocketAuth::Authenticate(
     int rv,
     NetLogWithSource& net_log,
@@ -77,17 +129,13 @@ int SOCKS5ClientSocketAuth::Authenticate(
     switch (next_state_) {
       case STATE_INIT_WRITE: {
         DCHECK_EQ(OK, rv);
-        // Initialize the buffer with
-        //        0x01, usernamelen, username, passwordlen, password
-        size_t usernamelen = username().size();
-        size_t passwordlen = password().size();
-        buffer_ = std::string(1 + 1 + usernamelen + 1 + passwordlen, 0);
-        buffer_[0] = 0x01;
-        buffer_[1] = usernamelen;
-        buffer_.replace(2, usernamelen, username());
-        buffer_[2 + usernamelen] = passwordlen;
-        buffer_.replace(2 + usernamelen + 1, passwordlen, password());
-        DCHECK_EQ(buffer_.size(), 2 + usernamelen + 1 + passwordlen);
+        buffer_ = BuildAuthRequest();
+        std::string handshake;
+        if (ShouldSendConnectWithAuth() &&
+            BuildHandshakeWriteBuffer(&handshake) == OK) {
+          buffer_.append(handshake);
+          handshake_written_ = true;
+        }
         buffer_left_ = buffer_.size();
         next_state_ = STATE_WRITE;
         rv = OK;
@@ -140,9 +188,14 @@ int SOCKS5ClientSocketAuth::Authenticate(
       case STATE_READ_COMPLETE:
         net_log.EndEventWithNetErrorCode(NetLogEventType::SOCKS5_AUTH_READ,
                                          std::max(rv, 0));
-        if (rv < 0) {
+        if (rv <= 0) {
+          if (handshake_written_) {
+            next_state_ = STATE_RETRY;
+            rv = OK;
+            break;
+          }
           next_state_ = STATE_BAD;
-          return rv;
+          return rv == 0 ? ERR_CONNECTION_CLOSED : rv;
         }
         DCHECK_LE(static_cast<size_t>(rv), buffer_left_);
         buffer_.append(iobuf_->data(), rv);
@@ -157,12 +210,48 @@ int SOCKS5ClientSocketAuth::Authenticate(
         static_assert(kSOCKSAuthUsernamePasswordResponseLen == 2, "bad size");
         uint8_t ver = buffer_[0];
         uint8_t status = buffer_[1];
-        next_state_ = STATE_BAD;  // Caller had better stop here.
-        if (ver != 0x01 || status != 0x00)
+        if (ver != 0x01 || status != 0x00) {
+          // The proxy may have been confused by the CONNECT request that
+          // followed the auth request.
+          if (handshake_written_) {
+            next_state_ = STATE_RETRY;
+            rv = OK;
+            break;
+          }
+          next_state_ = STATE_BAD;
           return ERR_FAILED;
+        }
+        next_state_ = STATE_BAD;  // Caller had better stop here.
+        // The CONNECT request is already out, only its reply is left.
+        if (handshake_written_)
+          SOCKS5ClientSocket::next_state_ =
+              SOCKS5ClientSocket::STATE_HANDSHAKE_READ;
         return OK;
       }
 
+      case STATE_RETRY:
+        // Whatever the proxy made of the pipelined requests, the connection
+        // can't be trusted anymore. Start over on a new one, one request at
+        // a time, and don't pipeline for this proxy again.
+        DCHECK_EQ(OK, rv);
+        GetProxiesWithoutOptimisticHandshake().insert(
+            proxy_host_port_.ToString());
+        handshake_written_ = false;
+        transport_socket_->Disconnect();
+        next_state_ = STATE_RETRY_COMPLETE;
+        rv = transport_socket_->Connect(callback);
+        break;
+
+      case STATE_RETRY_COMPLETE:
+        if (rv < 0) {
+          next_state_ = STATE_BAD;
+          return rv;
+        }
+        next_state_ = STATE_INIT_WRITE;
+        SOCKS5ClientSocket::buffer_.clear();
+        SOCKS5ClientSocket::next_state_ = SOCKS5ClientSocket::STATE_GREET_WRITE;
+        return OK;
+
       case STATE_BAD:
       default:
         NOTREACHED() << "bad state";
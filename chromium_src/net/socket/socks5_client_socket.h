@@ -21,6 +21,8 @@ class NET_EXPORT_PRIVATE SOCKS5ClientSocketAuth : public SOCKS5ClientSocket {
                          const HostPortPair& proxy_host_port);
   ~SOCKS5ClientSocketAuth() override;
 
+  static void ResetOptimisticHandshakeStateForTesting();
+
  private:
   bool do_auth();
   const std::string& username();
@@ -29,7 +31,11 @@ class NET_EXPORT_PRIVATE SOCKS5ClientSocketAuth : public SOCKS5ClientSocket {
   int Authenticate(int rv,
                    NetLogWithSource& net_log,
                    CompletionRepeatingCallback& callback) override;
+  bool ShouldSendConnectWithAuth();
+  std::string BuildAuthRequest();
   const HostPortPair proxy_host_port_;
+  // True if the CONNECT request went out with the auth request.
+  bool handshake_written_ = false;
   enum {
     STATE_INIT_WRITE = 0,
     STATE_WRITE,
@@ -38,6 +44,8 @@ class NET_EXPORT_PRIVATE SOCKS5ClientSocketAuth : public SOCKS5ClientSocket {
     STATE_READ,
     STATE_READ_COMPLETE,
     STATE_DONE,
+    STATE_RETRY,
+    STATE_RETRY_COMPLETE,
     STATE_BAD,
   } next_state_;
   scoped_refptr<IOBuffer> iobuf_;
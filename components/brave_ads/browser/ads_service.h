@@ -74,6 +74,7 @@ class AdsService : public KeyedService {
   virtual bool IsEnabled() const = 0;
   virtual void SetEnabled(const bool is_enabled) = 0;
 
+  virtual bool ShouldAllowConversionTracking() const = 0;
   virtual void SetAllowConversionTracking(const bool should_allow) = 0;
 
   virtual uint64_t GetAdsPerHour() const = 0;
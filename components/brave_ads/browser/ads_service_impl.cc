@@ -538,6 +538,10 @@ uint64_t AdsServiceImpl::GetAdsPerHour() const {
       static_cast<uint64_t>(ads::kMaximumAdNotificationsPerHour));
 }
 
+bool AdsServiceImpl::ShouldAllowConversionTracking() const {
+  return GetBooleanPref(ads::prefs::kShouldAllowConversionTracking);
+}
+
 bool AdsServiceImpl::ShouldAllowAdsSubdivisionTargeting() const {
   return GetBooleanPref(ads::prefs::kShouldAllowAdsSubdivisionTargeting);
 }
@@ -87,6 +87,7 @@ class AdsServiceImpl : public AdsService,
   bool IsEnabled() const override;
   void SetEnabled(const bool is_enabled) override;
 
+  bool ShouldAllowConversionTracking() const override;
   void SetAllowConversionTracking(const bool should_allow) override;
 
   uint64_t GetAdsPerHour() const override;
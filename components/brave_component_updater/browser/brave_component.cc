@@ -9,7 +9,9 @@
 
 #include "base/bind.h"
 #include "base/logging.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/sequenced_task_runner.h"
+#include "base/trace_event/trace_event.h"
 
 namespace brave_component_updater {
 
@@ -27,6 +29,7 @@ void BraveComponent::Register(const std::string& component_name,
   component_name_ = component_name;
   component_id_ = component_id;
   component_base64_public_key_ = component_base64_public_key;
+  register_time_ = base::TimeTicks::Now();
 
   auto registered_callback =
       base::BindOnce(&BraveComponent::OnComponentRegistered,
@@ -67,6 +70,31 @@ void BraveComponent::OnComponentReadyInternal(
     const base::FilePath& install_dir,
     const std::string& manifest) {
   VLOG(2) << "component ready: " << manifest;
+  if (load_priority_ == LoadPriority::kCritical) {
+    LoadComponent(component_id, install_dir, manifest);
+    return;
+  }
+
+  delegate_->PostAfterStartupTask(base::BindOnce(
+      &BraveComponent::LoadComponent, weak_factory_.GetWeakPtr(), component_id,
+      install_dir, manifest));
+}
+
+void BraveComponent::LoadComponent(const std::string& component_id,
+                                   const base::FilePath& install_dir,
+                                   const std::string& manifest) {
+  TRACE_EVENT1("browser", "BraveComponent::LoadComponent", "name",
+               component_name_);
+
+  if (!loaded_) {
+    loaded_ = true;
+    base::UmaHistogramLongTimes(
+        load_priority_ == LoadPriority::kCritical
+            ? "Brave.ComponentUpdater.TimeToLoad.Critical"
+            : "Brave.ComponentUpdater.TimeToLoad.AfterStartup",
+        base::TimeTicks::Now() - register_time_);
+  }
+
   OnComponentReady(component_id, install_dir, manifest);
 }
 
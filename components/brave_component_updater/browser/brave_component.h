@@ -13,6 +13,7 @@
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequenced_task_runner.h"
+#include "base/time/time.h"
 #include "components/component_updater/component_updater_service.h"
 
 class PrefService;
@@ -25,6 +26,14 @@ class BraveComponent {
                                                 const std::string& manifest)>;
   using ComponentObserver = update_client::UpdateClient::Observer;
 
+  // Components whose data is needed to handle the first requests are loaded as
+  // soon as they are ready, the others only once the browser has started up,
+  // so that their file reads don't compete with the first paint.
+  enum class LoadPriority {
+    kCritical,
+    kAfterStartup,
+  };
+
   class Delegate {
    public:
     virtual ~Delegate() = default;
@@ -42,6 +51,8 @@ class BraveComponent {
     // the observers are being notified.
     virtual void RemoveObserver(ComponentObserver* observer) = 0;
     virtual scoped_refptr<base::SequencedTaskRunner> GetTaskRunner() = 0;
+    // Runs |task| on the current sequence once browser startup is complete.
+    virtual void PostAfterStartupTask(base::OnceClosure task) = 0;
 
     // hacky temporary workaround for g_browser_process
     virtual const std::string locale() const = 0;
@@ -57,6 +68,11 @@ class BraveComponent {
   bool Unregister();
   scoped_refptr<base::SequencedTaskRunner> GetTaskRunner();
 
+  // Components are loaded after startup by default.
+  void set_load_priority(LoadPriority load_priority) {
+    load_priority_ = load_priority;
+  }
+
   // Adds an observer for ComponentObserver. An observer should not be added
   // more than once. The caller retains the ownership of the observer object.
   void AddObserver(ComponentObserver* observer);
@@ -77,10 +93,16 @@ class BraveComponent {
   void OnComponentReadyInternal(const std::string& component_id,
                                 const base::FilePath& install_dir,
                                 const std::string& manifest);
+  void LoadComponent(const std::string& component_id,
+                     const base::FilePath& install_dir,
+                     const std::string& manifest);
 
   std::string component_name_;
   std::string component_id_;
   std::string component_base64_public_key_;
+  LoadPriority load_priority_ = LoadPriority::kAfterStartup;
+  base::TimeTicks register_time_;
+  bool loaded_ = false;
   Delegate* delegate_;  // NOT OWNED
   base::WeakPtrFactory<BraveComponent> weak_factory_;
 
@@ -6,6 +6,8 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_H_
 #define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_H_
 
+#include <stddef.h>
+
 #include <string>
 #include <vector>
 
@@ -18,6 +20,21 @@ constexpr double kOutlierThreshold = 6;
 // if above 20MB _and_ more than 6x of the transfer size, probably an outlier
 constexpr double kSavingsAbsoluteOutlier = 20 << 20;
 
+// Returns the position of feature |name| in |feature_sequence|, or
+// |feature_count| if the model doesn't use it. Meant to be evaluated at
+// compile time so that callers can address the feature vector directly.
+constexpr size_t FeatureIndex(const char* name) {
+  for (size_t i = 0; i < feature_sequence.size(); i++) {
+    const char* feature = feature_sequence[i];
+    size_t j = 0;
+    while (feature[j] && feature[j] == name[j])
+      j++;
+    if (feature[j] == name[j])
+      return i;
+  }
+  return feature_count;
+}
+
 // Computes prediction based on the provided feature vector.
 // It is the client's responsibility to provide features in
 // the exact order expected by the predictor.
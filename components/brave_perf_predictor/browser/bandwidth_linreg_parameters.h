@@ -288,7 +288,7 @@ constexpr std::array<double, standardise_feat_count> standardise_feat_scale = {
 3333644.900695055
 };
 
-const std::array<std::string, feature_count> feature_sequence{
+constexpr std::array<const char*, feature_count> feature_sequence{
     "adblockRequests",
     "metrics.firstMeaningfulPaint",
     "metrics.observedDomContentLoaded",
@@ -10,6 +10,16 @@
 
 namespace brave_perf_predictor {
 
+TEST(BraveSavingsPredictorTest, FeatureIndexMatchesSequence) {
+  static_assert(FeatureIndex("adblockRequests") == 0,
+                "Feature index is resolved at compile time");
+  for (unsigned int i = 0; i < feature_count; i++) {
+    EXPECT_EQ(FeatureIndex(feature_sequence.at(i)), i);
+  }
+  EXPECT_EQ(FeatureIndex("transfer.total.size"),
+            static_cast<size_t>(feature_count));
+}
+
 TEST(BraveSavingsPredictorTest, FeatureArrayGetsPrediction) {
   const std::array<double, feature_count> features{};
   double result = LinregPredictVector(features);
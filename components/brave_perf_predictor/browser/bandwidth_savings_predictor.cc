@@ -5,9 +5,16 @@
 
 #include "brave/components/brave_perf_predictor/browser/bandwidth_savings_predictor.h"
 
+#include <initializer_list>
 #include <iostream>
+#include <utility>
+#include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg.h"
 #include "components/page_load_metrics/common/page_load_metrics.mojom.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
@@ -15,6 +22,97 @@
 
 namespace brave_perf_predictor {
 
+namespace {
+
+struct ResourceFeatures {
+  size_t request_count;
+  size_t size;
+};
+
+constexpr size_t kAdblockRequests = FeatureIndex("adblockRequests");
+constexpr size_t kFirstMeaningfulPaint =
+    FeatureIndex("metrics.firstMeaningfulPaint");
+constexpr size_t kObservedDomContentLoaded =
+    FeatureIndex("metrics.observedDomContentLoaded");
+constexpr size_t kObservedFirstVisualChange =
+    FeatureIndex("metrics.observedFirstVisualChange");
+constexpr size_t kObservedLoad = FeatureIndex("metrics.observedLoad");
+
+constexpr ResourceFeatures kDocumentResources = {
+    FeatureIndex("resources.document.requestCount"),
+    FeatureIndex("resources.document.size")};
+constexpr ResourceFeatures kStylesheetResources = {
+    FeatureIndex("resources.stylesheet.requestCount"),
+    FeatureIndex("resources.stylesheet.size")};
+constexpr ResourceFeatures kScriptResources = {
+    FeatureIndex("resources.script.requestCount"),
+    FeatureIndex("resources.script.size")};
+constexpr ResourceFeatures kImageResources = {
+    FeatureIndex("resources.image.requestCount"),
+    FeatureIndex("resources.image.size")};
+constexpr ResourceFeatures kFontResources = {
+    FeatureIndex("resources.font.requestCount"),
+    FeatureIndex("resources.font.size")};
+constexpr ResourceFeatures kMediaResources = {
+    FeatureIndex("resources.media.requestCount"),
+    FeatureIndex("resources.media.size")};
+constexpr ResourceFeatures kOtherResources = {
+    FeatureIndex("resources.other.requestCount"),
+    FeatureIndex("resources.other.size")};
+constexpr ResourceFeatures kThirdPartyResources = {
+    FeatureIndex("resources.third-party.requestCount"),
+    FeatureIndex("resources.third-party.size")};
+constexpr ResourceFeatures kTotalResources = {
+    FeatureIndex("resources.total.requestCount"),
+    FeatureIndex("resources.total.size")};
+
+constexpr bool AllFeaturesKnown(std::initializer_list<ResourceFeatures> list) {
+  for (const auto& features : list) {
+    if (features.request_count >= feature_count ||
+        features.size >= feature_count)
+      return false;
+  }
+  return true;
+}
+
+static_assert(kAdblockRequests < feature_count &&
+                  kFirstMeaningfulPaint < feature_count &&
+                  kObservedDomContentLoaded < feature_count &&
+                  kObservedFirstVisualChange < feature_count &&
+                  kObservedLoad < feature_count,
+              "Model is missing a metrics feature");
+static_assert(AllFeaturesKnown({kDocumentResources, kStylesheetResources,
+                                kScriptResources, kImageResources,
+                                kFontResources, kMediaResources,
+                                kOtherResources, kThirdPartyResources,
+                                kTotalResources}),
+              "Model is missing a resources feature");
+
+constexpr char kThirdPartyPrefix[] = "thirdParties.";
+constexpr char kThirdPartySuffix[] = ".blocked";
+
+// Maps third party entity names to their "thirdParties.<name>.blocked"
+// feature. Entities the model doesn't know about are not included.
+const base::flat_map<std::string, size_t>& GetThirdPartyFeatures() {
+  static const base::NoDestructor<base::flat_map<std::string, size_t>>
+      features([] {
+        std::vector<std::pair<std::string, size_t>> entries;
+        for (size_t i = 0; i < feature_sequence.size(); i++) {
+          base::StringPiece feature(feature_sequence[i]);
+          if (!base::StartsWith(feature, kThirdPartyPrefix) ||
+              !base::EndsWith(feature, kThirdPartySuffix))
+            continue;
+          feature.remove_prefix(sizeof(kThirdPartyPrefix) - 1);
+          feature.remove_suffix(sizeof(kThirdPartySuffix) - 1);
+          entries.emplace_back(feature.as_string(), i);
+        }
+        return base::flat_map<std::string, size_t>(std::move(entries));
+      }());
+  return *features;
+}
+
+}  // namespace
+
 BandwidthSavingsPredictor::BandwidthSavingsPredictor(
     const NamedThirdPartyRegistry* registry)
     : tp_registry_(registry) {}
@@ -25,34 +123,38 @@ void BandwidthSavingsPredictor::OnPageLoadTimingUpdated(
     const page_load_metrics::mojom::PageLoadTiming& timing) {
   // First meaningful paint
   if (timing.paint_timing->first_meaningful_paint.has_value())
-    feature_map_["metrics.firstMeaningfulPaint"] =
+    features_[kFirstMeaningfulPaint] =
         timing.paint_timing->first_meaningful_paint.value().InMillisecondsF();
 
   // DOM Content Loaded
   if (timing.document_timing->dom_content_loaded_event_start.has_value())
-    feature_map_["metrics.observedDomContentLoaded"] =
+    features_[kObservedDomContentLoaded] =
         timing.document_timing->dom_content_loaded_event_start.value()
             .InMillisecondsF();
 
   // First contentful paint
   if (timing.paint_timing->first_contentful_paint.has_value())
-    feature_map_["metrics.observedFirstVisualChange"] =
+    features_[kObservedFirstVisualChange] =
         timing.paint_timing->first_contentful_paint.value().InMillisecondsF();
 
   // Load
   if (timing.document_timing->load_event_start.has_value())
-    feature_map_["metrics.observedLoad"] =
+    features_[kObservedLoad] =
         timing.document_timing->load_event_start.value().InMillisecondsF();
 }
 
 void BandwidthSavingsPredictor::OnSubresourceBlocked(
-    const std::string& resource_url) {
-  feature_map_["adblockRequests"] += 1;
+    const GURL& resource_url) {
+  features_[kAdblockRequests] += 1;
 
   if (tp_registry_) {
     const auto tp_name = tp_registry_->GetThirdParty(resource_url);
-    if (tp_name.has_value())
-      feature_map_["thirdParties." + tp_name.value() + ".blocked"] = 1;
+    if (!tp_name.has_value())
+      return;
+    const auto& tp_features = GetThirdPartyFeatures();
+    const auto it = tp_features.find(tp_name.value());
+    if (it != tp_features.end())
+      features_[it->second] = 1;
   }
 }
 
@@ -73,47 +175,43 @@ void BandwidthSavingsPredictor::OnResourceLoadComplete(
           net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
 
   if (is_third_party) {
-    feature_map_["resources.third-party.requestCount"] += 1;
-    feature_map_["resources.third-party.size"] +=
-        resource_load_info.raw_body_bytes;
+    features_[kThirdPartyResources.request_count] += 1;
+    features_[kThirdPartyResources.size] += resource_load_info.raw_body_bytes;
   }
 
-  feature_map_["resources.total.requestCount"] += 1;
-  feature_map_["resources.total.size"] += resource_load_info.raw_body_bytes;
-  feature_map_["transfer.total.size"] +=
-      resource_load_info.total_received_bytes;
-  std::string resource_type;
+  features_[kTotalResources.request_count] += 1;
+  features_[kTotalResources.size] += resource_load_info.raw_body_bytes;
+  transfer_total_size_ += resource_load_info.total_received_bytes;
+
+  const ResourceFeatures* resource_features;
   switch (resource_load_info.request_destination) {
     case network::mojom::RequestDestination::kDocument:
-      resource_type = "document";
-      break;
     case network::mojom::RequestDestination::kIframe:
-      resource_type = "document";
+      resource_features = &kDocumentResources;
       break;
     case network::mojom::RequestDestination::kStyle:
-      resource_type = "stylesheet";
+      resource_features = &kStylesheetResources;
       break;
     case network::mojom::RequestDestination::kScript:
-      resource_type = "script";
+      resource_features = &kScriptResources;
       break;
     case network::mojom::RequestDestination::kImage:
-      resource_type = "image";
+      resource_features = &kImageResources;
       break;
     case network::mojom::RequestDestination::kFont:
-      resource_type = "font";
+      resource_features = &kFontResources;
       break;
     case network::mojom::RequestDestination::kAudio:
     case network::mojom::RequestDestination::kTrack:
     case network::mojom::RequestDestination::kVideo:
-      resource_type = "media";
+      resource_features = &kMediaResources;
       break;
     default:
-      resource_type = "other";
+      resource_features = &kOtherResources;
       break;
   }
-  feature_map_["resources." + resource_type + ".requestCount"] += 1;
-  feature_map_["resources." + resource_type + ".size"] +=
-      resource_load_info.raw_body_bytes;
+  features_[resource_features->request_count] += 1;
+  features_[resource_features->size] += resource_load_info.raw_body_bytes;
 }
 
 double BandwidthSavingsPredictor::PredictSavingsBytes() const {
@@ -121,37 +219,37 @@ double BandwidthSavingsPredictor::PredictSavingsBytes() const {
       !main_frame_url_.SchemeIsHTTPOrHTTPS()) {
     return 0;
   }
-  const auto total_size = feature_map_.find("transfer.total.size");
-  if (total_size != feature_map_.end() && total_size->second > 0) {
-    VLOG(2) << main_frame_url_ << " total download size " << total_size->second
-            << " bytes";
+  if (transfer_total_size_ > 0) {
+    VLOG(2) << main_frame_url_ << " total download size "
+            << transfer_total_size_ << " bytes";
   } else {
     return 0;
   }
 
   // Short-circuit if nothing got blocked
-  const auto adblock_requests = feature_map_.find("adblockRequests");
-  if (adblock_requests == feature_map_.end() || adblock_requests->second < 1) {
+  if (features_[kAdblockRequests] < 1) {
     return 0;
   }
   if (VLOG_IS_ON(3)) {
-    VLOG(3) << "Predicting on feature map:";
-    for (const auto& feature : feature_map_) {
-      VLOG(3) << feature.first << " :: " << feature.second;
+    VLOG(3) << "Predicting on features:";
+    for (size_t i = 0; i < features_.size(); i++) {
+      if (features_[i] != 0)
+        VLOG(3) << feature_sequence[i] << " :: " << features_[i];
     }
   }
-  double prediction = ::brave_perf_predictor::LinregPredictNamed(feature_map_);
+  double prediction = ::brave_perf_predictor::LinregPredictVector(features_);
   VLOG(2) << main_frame_url_ << " estimated saving " << prediction << " bytes";
   // Sanity check for predicted saving
   if (prediction > kSavingsAbsoluteOutlier &&
-      (prediction / kOutlierThreshold) > total_size->second) {
+      (prediction / kOutlierThreshold) > transfer_total_size_) {
     return 0;
   }
   return prediction;
 }
 
 void BandwidthSavingsPredictor::Reset() {
-  feature_map_.clear();
+  features_.fill(0);
+  transfer_total_size_ = 0;
   main_frame_url_ = {};
 }
 
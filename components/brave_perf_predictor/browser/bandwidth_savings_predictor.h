@@ -6,10 +6,10 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_SAVINGS_PREDICTOR_H_
 #define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_SAVINGS_PREDICTOR_H_
 
+#include <array>
 #include <string>
 
-#include "base/containers/flat_map.h"
-#include "base/gtest_prod_util.h"
+#include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
 #include "brave/components/brave_perf_predictor/browser/named_third_party_registry.h"
 #include "url/gurl.h"
 
@@ -49,7 +49,7 @@ class BandwidthSavingsPredictor {
 
   void OnPageLoadTimingUpdated(
       const page_load_metrics::mojom::PageLoadTiming& timing);
-  void OnSubresourceBlocked(const std::string& resource_url);
+  void OnSubresourceBlocked(const GURL& resource_url);
   void OnResourceLoadComplete(
       const GURL& main_frame_url,
       const blink::mojom::ResourceLoadInfo& resource_load_info);
@@ -57,14 +57,14 @@ class BandwidthSavingsPredictor {
   void Reset();
 
  private:
-  FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest, FeaturiseBlocked);
-  FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest, FeaturiseTiming);
-  FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest,
-                           FeaturiseResourceLoading);
+  friend class BandwidthSavingsPredictorTest;
 
   GURL main_frame_url_;
   const NamedThirdPartyRegistry* tp_registry_;  // not owned
-  base::flat_map<std::string, double> feature_map_;
+  // Model features, in |feature_sequence| order.
+  std::array<double, feature_count> features_{};
+  // Not a model feature, only used to sanity check the prediction.
+  double transfer_total_size_ = 0;
 };
 
 }  // namespace brave_perf_predictor
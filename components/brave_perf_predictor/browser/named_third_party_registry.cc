@@ -125,13 +125,12 @@ void NamedThirdPartyRegistry::UpdateMappings(
 }
 
 base::Optional<std::string> NamedThirdPartyRegistry::GetThirdParty(
-    const base::StringPiece request_url) const {
+    const GURL& url) const {
   if (!IsInitialized()) {
     VLOG(2) << "Named Third Party Registry not initialized";
     return base::nullopt;
   }
 
-  const GURL url(request_url);
   if (!url.is_valid())
     return base::nullopt;
 
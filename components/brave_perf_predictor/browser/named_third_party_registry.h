@@ -14,6 +14,8 @@
 #include "base/values.h"
 #include "components/keyed_service/core/keyed_service.h"
 
+class GURL;
+
 namespace brave_perf_predictor {
 
 // Retrieves publicly known Third Party (organisation) for a given URL, using
@@ -33,8 +35,7 @@ class NamedThirdPartyRegistry : public KeyedService {
   bool LoadMappings(const base::StringPiece entities, bool discard_irrelevant);
   // Default initialization - asynchronously load from bundled resource
   void InitializeDefault();
-  base::Optional<std::string> GetThirdParty(
-      const base::StringPiece domain) const;
+  base::Optional<std::string> GetThirdParty(const GURL& url) const;
 
  private:
   bool IsInitialized() const { return initialized_; }
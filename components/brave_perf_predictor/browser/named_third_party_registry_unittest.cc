@@ -9,6 +9,7 @@
 #include "base/files/file_util.h"
 #include "base/path_service.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
 
 namespace brave_perf_predictor {
 
@@ -88,7 +89,8 @@ TEST(NamedThirdPartyRegistryTest, ExtractsThirdPartyURLTest) {
   auto dataset = LoadFile();
   extractor->LoadMappings(dataset, true);
 
-  auto entity = extractor->GetThirdParty("https://google-analytics.com/ga.js");
+  auto entity =
+      extractor->GetThirdParty(GURL("https://google-analytics.com/ga.js"));
   ASSERT_TRUE(entity.has_value());
   EXPECT_EQ(entity.value(), "Google Analytics");
 }
@@ -97,7 +99,7 @@ TEST(NamedThirdPartyRegistryTest, ExtractsThirdPartyHostnameTest) {
   NamedThirdPartyRegistry* extractor = new NamedThirdPartyRegistry();
   auto dataset = LoadFile();
   extractor->LoadMappings(dataset, true);
-  auto entity = extractor->GetThirdParty("https://google-analytics.com");
+  auto entity = extractor->GetThirdParty(GURL("https://google-analytics.com"));
   ASSERT_TRUE(entity.has_value());
   EXPECT_EQ(entity.value(), "Google Analytics");
 }
@@ -106,7 +108,7 @@ TEST(NamedThirdPartyRegistryTest, ExtractsThirdPartyRootDomainTest) {
   NamedThirdPartyRegistry* extractor = new NamedThirdPartyRegistry();
   auto dataset = LoadFile();
   extractor->LoadMappings(dataset, true);
-  auto entity = extractor->GetThirdParty("https://test.m.facebook.com");
+  auto entity = extractor->GetThirdParty(GURL("https://test.m.facebook.com"));
   ASSERT_TRUE(entity.has_value());
   EXPECT_EQ(entity.value(), "Facebook");
 }
@@ -115,7 +117,7 @@ TEST(NamedThirdPartyRegistryTest, HandlesUnrecognisedThirdPartyTest) {
   NamedThirdPartyRegistry* extractor = new NamedThirdPartyRegistry();
   auto dataset = LoadFile();
   extractor->LoadMappings(dataset, true);
-  auto entity = extractor->GetThirdParty("http://example.com");
+  auto entity = extractor->GetThirdParty(GURL("http://example.com"));
   EXPECT_FALSE(entity.has_value());
 }
 
@@ -50,7 +50,7 @@ void PerfPredictorTabHelper::RegisterProfilePrefs(
 
 // static
 void PerfPredictorTabHelper::DispatchBlockedEvent(
-    const std::string& subresource,
+    const GURL& request_url,
     int frame_tree_node_id) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
@@ -63,7 +63,7 @@ void PerfPredictorTabHelper::DispatchBlockedEvent(
       brave_perf_predictor::PerfPredictorTabHelper::FromWebContents(
           web_contents);
   if (blocking_observer) {
-    blocking_observer->OnBlockedSubresource(subresource);
+    blocking_observer->OnBlockedSubresource(request_url);
   }
 }
 
@@ -96,8 +96,8 @@ void PerfPredictorTabHelper::RecordSavings() {
 }
 
 void PerfPredictorTabHelper::OnBlockedSubresource(
-    const std::string& subresource) {
-  bandwidth_predictor_->OnSubresourceBlocked(subresource);
+    const GURL& request_url) {
+  bandwidth_predictor_->OnSubresourceBlocked(request_url);
 }
 
 void PerfPredictorTabHelper::DidStartNavigation(
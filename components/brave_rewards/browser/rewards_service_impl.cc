@@ -759,6 +759,16 @@ void RewardsServiceImpl::OnXHRLoad(SessionID tab_id,
     return;
   }
 
+  // Most loads are unrelated to media providers, so filter them here rather
+  // than sending every one of them to the ledger process only to be dropped.
+  // Media processing needs query parameters as well.
+  if (!url.has_query() ||
+      !ledger::Ledger::IsSupportedMediaLink(url.spec(),
+                                            first_party_url.spec(),
+                                            referrer.spec())) {
+    return;
+  }
+
   base::flat_map<std::string, std::string> parts;
 
   for (net::QueryIterator it(url); !it.IsAtEnd(); it.Advance()) {
@@ -24,6 +24,8 @@ BaseBraveShieldsService::BaseBraveShieldsService(
     BraveComponent::Delegate* delegate)
     : BraveComponent(delegate),
       initialized_(false) {
+  // Requests are checked against shields lists from the first page load on.
+  set_load_priority(LoadPriority::kCritical);
 }
 
 BaseBraveShieldsService::~BaseBraveShieldsService() {
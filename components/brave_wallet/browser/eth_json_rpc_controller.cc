@@ -5,9 +5,13 @@
 
 #include "brave/components/brave_wallet/browser/eth_json_rpc_controller.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "base/environment.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_utils.h"
 #include "brave/components/brave_wallet/browser/eth_call_data_builder.h"
 #include "brave/components/brave_wallet/browser/eth_requests.h"
@@ -43,6 +47,19 @@ net::NetworkTrafficAnnotationTag GetNetworkTrafficAnnotationTag() {
 
 const unsigned int kRetriesCountOnNetworkChange = 1;
 
+// Roughly one mainnet block. Cached reads are refreshed at most this often.
+constexpr base::TimeDelta kResponseCacheLifetime =
+    base::TimeDelta::FromSeconds(12);
+
+bool IsSuccessStatus(int status) {
+  return status >= 200 && status <= 299;
+}
+
+// Only responses carrying a result are worth caching, not JSON-RPC errors.
+bool HasResult(const base::Value& response) {
+  return response.is_dict() && response.FindKey("result");
+}
+
 std::string GetInfuraProjectID() {
   std::string project_id(BRAVE_INFURA_PROJECT_ID);
   std::unique_ptr<base::Environment> env(base::Environment::Create());
@@ -76,6 +93,13 @@ EthJsonRpcController::EthJsonRpcController(
 
 EthJsonRpcController::~EthJsonRpcController() {}
 
+EthJsonRpcController::CachedResponse::CachedResponse() = default;
+EthJsonRpcController::CachedResponse::CachedResponse(CachedResponse&&) =
+    default;
+EthJsonRpcController::CachedResponse&
+EthJsonRpcController::CachedResponse::operator=(CachedResponse&&) = default;
+EthJsonRpcController::CachedResponse::~CachedResponse() = default;
+
 void EthJsonRpcController::AddObserver(
     BraveWalletProviderEventsObserver* observer) {
   observers_->AddObserver(observer);
@@ -89,8 +113,16 @@ void EthJsonRpcController::RemoveObserver(
 void EthJsonRpcController::Request(const std::string& json_payload,
                                    URLRequestCallback callback,
                                    bool auto_retry_on_network_change) {
+  SendRequest(network_url_, json_payload, std::move(callback),
+              auto_retry_on_network_change);
+}
+
+void EthJsonRpcController::SendRequest(const GURL& url,
+                                       const std::string& json_payload,
+                                       URLRequestCallback callback,
+                                       bool auto_retry_on_network_change) {
   auto request = std::make_unique<network::ResourceRequest>();
-  request->url = network_url_;
+  request->url = url;
   request->load_flags = net::LOAD_BYPASS_CACHE | net::LOAD_DISABLE_CACHE |
                         net::LOAD_DO_NOT_SAVE_COOKIES;
   request->credentials_mode = network::mojom::CredentialsMode::kOmit;
@@ -138,6 +170,180 @@ void EthJsonRpcController::OnURLLoaderComplete(
                           headers);
 }
 
+void EthJsonRpcController::RequestCoalesced(const std::string& json_payload,
+                                            URLRequestCallback callback) {
+  CallKey key(network_url_, json_payload);
+
+  auto cached = response_cache_.find(key);
+  if (cached != response_cache_.end()) {
+    if (base::TimeTicks::Now() - cached->second.time < kResponseCacheLifetime) {
+      // Keep the callback asynchronous, like a network response.
+      base::SequencedTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE,
+          base::BindOnce(std::move(callback), cached->second.status,
+                         cached->second.body, cached->second.headers));
+      return;
+    }
+    response_cache_.erase(cached);
+  }
+
+  auto& callbacks = in_flight_calls_[key];
+  callbacks.push_back(std::move(callback));
+  if (callbacks.size() > 1)
+    return;
+
+  pending_calls_.push_back(std::move(key));
+  if (pending_calls_.size() == 1) {
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&EthJsonRpcController::FlushPendingCalls,
+                                  weak_ptr_factory_.GetWeakPtr()));
+  }
+}
+
+void EthJsonRpcController::FlushPendingCalls() {
+  if (pending_calls_.empty())
+    return;
+
+  std::vector<CallKey> keys;
+  keys.swap(pending_calls_);
+  // Pending calls are flushed before every network change, so they all go to
+  // the same endpoint.
+  const GURL url = keys.front().first;
+
+  // Drop expired entries here rather than on a timer.
+  const base::TimeTicks now = base::TimeTicks::Now();
+  for (auto it = response_cache_.begin(); it != response_cache_.end();) {
+    if (now - it->second.time >= kResponseCacheLifetime)
+      it = response_cache_.erase(it);
+    else
+      ++it;
+  }
+
+  // Large batches are split, so that a batch the endpoint rejects or times
+  // out on only holds back a bounded number of calls.
+  for (size_t begin = 0; begin < keys.size(); begin += kMaxCallsPerBatch) {
+    const size_t end = std::min(keys.size(), begin + kMaxCallsPerBatch);
+    SendBatch(url, std::vector<CallKey>(keys.begin() + begin,
+                                        keys.begin() + end));
+  }
+}
+
+void EthJsonRpcController::SendBatch(const GURL& url,
+                                     std::vector<CallKey> keys) {
+  // A lone call is sent as is, which also keeps working with endpoints that
+  // don't support batches.
+  if (keys.size() == 1) {
+    SendCoalescedCall(keys.front());
+    return;
+  }
+
+  // Number the calls so that responses, which may come back in any order,
+  // can be matched to them.
+  base::Value batch(base::Value::Type::LIST);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    base::Optional<base::Value> call = base::JSONReader::Read(keys[i].second);
+    DCHECK(call && call->is_dict());
+    call->SetIntKey("id", static_cast<int>(i));
+    batch.Append(std::move(*call));
+  }
+  std::string json_payload;
+  base::JSONWriter::Write(batch, &json_payload);
+
+  SendRequest(url, json_payload,
+              base::BindOnce(&EthJsonRpcController::OnBatchResponse,
+                             base::Unretained(this), std::move(keys)),
+              true);
+}
+
+void EthJsonRpcController::SendCoalescedCall(const CallKey& key) {
+  SendRequest(key.first, key.second,
+              base::BindOnce(&EthJsonRpcController::OnCoalescedCallResponse,
+                             base::Unretained(this), key),
+              true);
+}
+
+void EthJsonRpcController::OnBatchResponse(
+    const std::vector<CallKey>& keys,
+    const int status,
+    const std::string& body,
+    const std::map<std::string, std::string>& headers) {
+  // Resending the calls one by one would only add load to an endpoint which
+  // is failing or rate limiting us.
+  if (!IsSuccessStatus(status)) {
+    for (const auto& key : keys)
+      CompleteCoalescedCall(key, status, body, headers, false);
+    return;
+  }
+
+  std::vector<bool> answered(keys.size(), false);
+  base::Optional<base::Value> responses = base::JSONReader::Read(body);
+  if (responses && responses->is_list()) {
+    for (const auto& response : responses->GetList()) {
+      const base::Optional<int> id =
+          response.is_dict() ? response.FindIntKey("id") : base::nullopt;
+      if (!id || *id < 0 || static_cast<size_t>(*id) >= keys.size() ||
+          answered[*id]) {
+        continue;
+      }
+      answered[*id] = true;
+      std::string response_body;
+      base::JSONWriter::Write(response, &response_body);
+      CompleteCoalescedCall(keys[*id], status, response_body, headers,
+                            HasResult(response));
+    }
+  }
+
+  // The endpoint doesn't support batches or it left calls out, send those one
+  // by one.
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!answered[i])
+      SendCoalescedCall(keys[i]);
+  }
+}
+
+void EthJsonRpcController::OnCoalescedCallResponse(
+    const CallKey& key,
+    const int status,
+    const std::string& body,
+    const std::map<std::string, std::string>& headers) {
+  bool cacheable = false;
+  if (IsSuccessStatus(status)) {
+    base::Optional<base::Value> response = base::JSONReader::Read(body);
+    cacheable = response && HasResult(*response);
+  }
+  CompleteCoalescedCall(key, status, body, headers, cacheable);
+}
+
+void EthJsonRpcController::CompleteCoalescedCall(
+    const CallKey& key,
+    const int status,
+    const std::string& body,
+    const std::map<std::string, std::string>& headers,
+    bool cacheable) {
+  auto it = in_flight_calls_.find(key);
+  if (it == in_flight_calls_.end())
+    return;
+  std::vector<URLRequestCallback> callbacks = std::move(it->second);
+  in_flight_calls_.erase(it);
+
+  // Responses for an endpoint we have since switched away from are still
+  // delivered, but not kept.
+  if (cacheable && key.first == network_url_) {
+    CachedResponse& cached = response_cache_[key];
+    cached.status = status;
+    cached.body = body;
+    cached.headers = headers;
+    cached.time = base::TimeTicks::Now();
+  }
+
+  for (auto& callback : callbacks)
+    std::move(callback).Run(status, body, headers);
+}
+
+void EthJsonRpcController::ClearResponseCache() {
+  response_cache_.clear();
+}
+
 Network EthJsonRpcController::GetNetwork() const {
   return network_;
 }
@@ -147,6 +353,9 @@ GURL EthJsonRpcController::GetNetworkURL() const {
 }
 
 void EthJsonRpcController::SetNetwork(Network network) {
+  FlushPendingCalls();
+  ClearResponseCache();
+
   std::string subdomain;
   network_ = network;
   switch (network) {
@@ -185,6 +394,9 @@ void EthJsonRpcController::SetNetwork(Network network) {
 }
 
 void EthJsonRpcController::SetCustomNetwork(const GURL& network_url) {
+  FlushPendingCalls();
+  ClearResponseCache();
+
   network_ = Network::kCustom;
   network_url_ = network_url;
 }
@@ -195,8 +407,8 @@ void EthJsonRpcController::GetBalance(
   auto internal_callback =
       base::BindOnce(&EthJsonRpcController::OnGetBalance,
                      base::Unretained(this), std::move(callback));
-  return Request(eth_getBalance(address, "latest"),
-                 std::move(internal_callback), true);
+  RequestCoalesced(eth_getBalance(address, "latest"),
+                   std::move(internal_callback));
 }
 
 void EthJsonRpcController::OnGetBalance(
@@ -228,8 +440,8 @@ bool EthJsonRpcController::GetERC20TokenBalance(
   if (!erc20::BalanceOf(address, &data)) {
     return false;
   }
-  Request(eth_call("", address, "", "", "", data, ""),
-          std::move(internal_callback), true);
+  RequestCoalesced(eth_call("", address, "", "", "", data, ""),
+                   std::move(internal_callback));
   return true;
 }
 
@@ -263,8 +475,8 @@ bool EthJsonRpcController::EnsProxyReaderResolveAddress(
     return false;
   }
 
-  Request(eth_call("", contract_address, "", "", "", data, "latest"),
-          std::move(internal_callback), true);
+  RequestCoalesced(eth_call("", contract_address, "", "", "", data, "latest"),
+                   std::move(internal_callback));
   return true;
 }
 
@@ -299,8 +511,8 @@ bool EthJsonRpcController::UnstoppableDomainsProxyReaderGetMany(
     return false;
   }
 
-  Request(eth_call("", contract_address, "", "", "", data, "latest"),
-          std::move(internal_callback), true);
+  RequestCoalesced(eth_call("", contract_address, "", "", "", data, "latest"),
+                   std::move(internal_callback));
   return true;
 }
 
@@ -10,10 +10,13 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/callback.h"
+#include "base/memory/weak_ptr.h"
 #include "base/observer_list_threadsafe.h"
+#include "base/time/time.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_provider_events_observer.h"
 #include "url/gurl.h"
@@ -25,6 +28,10 @@ class SimpleURLLoader;
 
 namespace brave_wallet {
 
+// Wallet reads (balances, token balances, ENS and Unstoppable Domains lookups)
+// issued in the same task are coalesced into a single JSON-RPC 2.0 batch POST.
+// Identical reads share one in-flight request, and successful responses are
+// cached for about one block. Request() always sends its payload as is.
 class EthJsonRpcController {
  public:
   EthJsonRpcController(
@@ -77,9 +84,55 @@ class EthJsonRpcController {
   static std::string GetChainIDFromNetwork(Network network);
   static GURL GetBlockTrackerURLFromNetwork(Network network);
 
+  // Calls queued together beyond this are sent in several batches.
+  static constexpr size_t kMaxCallsPerBatch = 20;
+
  private:
   using SimpleURLLoaderList =
       std::list<std::unique_ptr<network::SimpleURLLoader>>;
+  // A read is identified by the endpoint it goes to and its payload, which
+  // carries the method, params and block tag.
+  using CallKey = std::pair<GURL, std::string>;
+
+  struct CachedResponse {
+    CachedResponse();
+    CachedResponse(CachedResponse&&);
+    CachedResponse& operator=(CachedResponse&&);
+    ~CachedResponse();
+
+    int status = 0;
+    std::string body;
+    std::map<std::string, std::string> headers;
+    base::TimeTicks time;
+  };
+
+  void SendRequest(const GURL& url,
+                   const std::string& json_payload,
+                   URLRequestCallback callback,
+                   bool auto_retry_on_network_change);
+  // Queues a read-only call for the next batch, or answers it from the cache
+  // or an identical call already in flight.
+  void RequestCoalesced(const std::string& json_payload,
+                        URLRequestCallback callback);
+  void FlushPendingCalls();
+  void SendBatch(const GURL& url, std::vector<CallKey> keys);
+  void SendCoalescedCall(const CallKey& key);
+  void OnBatchResponse(const std::vector<CallKey>& keys,
+                       const int status,
+                       const std::string& body,
+                       const std::map<std::string, std::string>& headers);
+  void OnCoalescedCallResponse(
+      const CallKey& key,
+      const int status,
+      const std::string& body,
+      const std::map<std::string, std::string>& headers);
+  void CompleteCoalescedCall(const CallKey& key,
+                             const int status,
+                             const std::string& body,
+                             const std::map<std::string, std::string>& headers,
+                             bool cacheable);
+  void ClearResponseCache();
+
   void OnURLLoaderComplete(SimpleURLLoaderList::iterator iter,
                            URLRequestCallback callback,
                            const std::unique_ptr<std::string> response_body);
@@ -111,6 +164,14 @@ class EthJsonRpcController {
   scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
   scoped_refptr<base::ObserverListThreadSafe<BraveWalletProviderEventsObserver>>
       observers_;
+
+  // Calls queued in the current task, sent together by FlushPendingCalls().
+  std::vector<CallKey> pending_calls_;
+  // Callbacks of every queued or sent coalesced call.
+  std::map<CallKey, std::vector<URLRequestCallback>> in_flight_calls_;
+  std::map<CallKey, CachedResponse> response_cache_;
+
+  base::WeakPtrFactory<EthJsonRpcController> weak_ptr_factory_{this};
 };
 
 }  // namespace brave_wallet
@@ -3,20 +3,131 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/bind.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
 #include "brave/components/brave_wallet/browser/eth_json_rpc_controller.h"
 #include "content/public/browser/storage_partition.h"
 #include "content/public/test/browser_task_environment.h"
 #include "content/public/test/test_browser_context.h"
+#include "net/http/http_status_code.h"
+#include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
 #include "services/network/test/test_shared_url_loader_factory.h"
+#include "services/network/test/test_url_loader_factory.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "url/gurl.h"
 
 namespace brave_wallet {
 
+namespace {
+
+std::string GetUploadData(const network::ResourceRequest& request) {
+  std::string upload_data;
+  if (!request.request_body)
+    return upload_data;
+  for (const network::DataElement& element :
+       *request.request_body->elements()) {
+    if (element.type() == network::mojom::DataElementDataView::Tag::kBytes) {
+      const auto& bytes = element.As<network::DataElementBytes>().bytes();
+      upload_data.append(bytes.begin(), bytes.end());
+    }
+  }
+  return upload_data;
+}
+
+// Answers a call with its first param, or the "to" address for eth_call, so
+// tests can tell which call a response went to.
+base::Value AnswerCall(const base::Value& call) {
+  base::Value response(base::Value::Type::DICTIONARY);
+  response.SetStringKey("jsonrpc", "2.0");
+  response.SetKey("id", call.FindKey("id")->Clone());
+  const base::Value& param = call.FindListKey("params")->GetList()[0];
+  response.SetStringKey("result", param.is_string()
+                                      ? param.GetString()
+                                      : *param.FindStringKey("to"));
+  return response;
+}
+
+}  // namespace
+
+// Fake JSON-RPC endpoint counting requests and uploaded bytes.
+class FakeJsonRpcEndpoint {
+ public:
+  enum class BatchSupport {
+    kSupported,
+    // Answers batches with a JSON-RPC error.
+    kUnsupported,
+    // Answers batches with an HTTP error.
+    kFailing,
+  };
+
+  explicit FakeJsonRpcEndpoint(BatchSupport batch_support)
+      : batch_support_(batch_support),
+        shared_url_loader_factory_(
+            base::MakeRefCounted<network::WeakWrapperSharedURLLoaderFactory>(
+                &url_loader_factory_)) {
+    url_loader_factory_.SetInterceptor(base::BindLambdaForTesting(
+        [&](const network::ResourceRequest& request) {
+          const std::string upload_data = GetUploadData(request);
+          request_count_++;
+          upload_bytes_ += upload_data.size();
+
+          base::Optional<base::Value> payload =
+              base::JSONReader::Read(upload_data);
+          ASSERT_TRUE(payload);
+          if (payload->is_list()) {
+            largest_batch_ =
+                std::max(largest_batch_, payload->GetList().size());
+          }
+          base::Value response;
+          if (!payload->is_list()) {
+            response = AnswerCall(*payload);
+          } else if (batch_support_ == BatchSupport::kFailing) {
+            url_loader_factory_.AddResponse(request.url.spec(), "",
+                                            net::HTTP_SERVICE_UNAVAILABLE);
+            return;
+          } else if (batch_support_ == BatchSupport::kSupported) {
+            response = base::Value(base::Value::Type::LIST);
+            // Answer in reverse order, which the spec allows.
+            const auto& calls = payload->GetList();
+            for (auto it = calls.rbegin(); it != calls.rend(); ++it)
+              response.Append(AnswerCall(*it));
+          } else {
+            response = base::Value(base::Value::Type::DICTIONARY);
+            response.SetStringKey("jsonrpc", "2.0");
+            response.SetKey("id", base::Value());
+            response.SetStringPath("error.message", "Batches not supported");
+          }
+          std::string response_body;
+          base::JSONWriter::Write(response, &response_body);
+          url_loader_factory_.AddResponse(request.url.spec(), response_body);
+        }));
+  }
+
+  scoped_refptr<network::SharedURLLoaderFactory> shared_url_loader_factory() {
+    return shared_url_loader_factory_;
+  }
+  int request_count() const { return request_count_; }
+  size_t upload_bytes() const { return upload_bytes_; }
+  size_t largest_batch() const { return largest_batch_; }
+
+ private:
+  BatchSupport batch_support_;
+  int request_count_ = 0;
+  size_t upload_bytes_ = 0;
+  size_t largest_batch_ = 0;
+  network::TestURLLoaderFactory url_loader_factory_;
+  scoped_refptr<network::SharedURLLoaderFactory> shared_url_loader_factory_;
+};
+
 class EthJsonRpcControllerUnitTest : public testing::Test {
  public:
   EthJsonRpcControllerUnitTest()
@@ -85,4 +196,155 @@ TEST_F(EthJsonRpcControllerUnitTest, SetCustomNetwork) {
   ASSERT_EQ(controller.GetNetworkURL(), custom_network);
 }
 
+TEST_F(EthJsonRpcControllerUnitTest, BatchesCallsIssuedTogether) {
+  FakeJsonRpcEndpoint endpoint(FakeJsonRpcEndpoint::BatchSupport::kSupported);
+  EthJsonRpcController controller(Network::kMainnet,
+                                  endpoint.shared_url_loader_factory());
+  const std::vector<std::string> addresses = {
+      "0x4e02f254184E904300e0775E4b8eeCB1", "0x4e02f254184E904300e0775E4b8eeCB2",
+      "0x4e02f254184E904300e0775E4b8eeCB3"};
+
+  base::RunLoop run_loop;
+  size_t responses = 0;
+  for (const auto& address : addresses) {
+    controller.GetBalance(
+        address, base::BindLambdaForTesting(
+                     [&, address](bool status, const std::string& balance) {
+                       EXPECT_TRUE(status);
+                       EXPECT_EQ(balance, address);
+                       if (++responses == addresses.size() + 1)
+                         run_loop.Quit();
+                     }));
+  }
+  EXPECT_TRUE(controller.GetERC20TokenBalance(
+      "0x0d8775f648430679a709e98d2b0cb6250d2887ef", addresses[0],
+      base::BindLambdaForTesting(
+          [&](bool status, const std::string& balance) {
+            EXPECT_TRUE(status);
+            EXPECT_EQ(balance, addresses[0]);
+            if (++responses == addresses.size() + 1)
+              run_loop.Quit();
+          })));
+  run_loop.Run();
+
+  EXPECT_EQ(endpoint.request_count(), 1);
+}
+
+TEST_F(EthJsonRpcControllerUnitTest, DedupesAndCachesCalls) {
+  FakeJsonRpcEndpoint endpoint(FakeJsonRpcEndpoint::BatchSupport::kSupported);
+  EthJsonRpcController controller(Network::kMainnet,
+                                  endpoint.shared_url_loader_factory());
+  const std::string address = "0x4e02f254184E904300e0775E4b8eeCB1";
+
+  auto get_balances = [&](int count) {
+    base::RunLoop run_loop;
+    int responses = 0;
+    for (int i = 0; i < count; ++i) {
+      controller.GetBalance(
+          address, base::BindLambdaForTesting(
+                       [&](bool status, const std::string& balance) {
+                         EXPECT_TRUE(status);
+                         EXPECT_EQ(balance, address);
+                         if (++responses == count)
+                           run_loop.Quit();
+                       }));
+    }
+    run_loop.Run();
+  };
+
+  // Identical calls share a single request, sent unbatched.
+  get_balances(3);
+  EXPECT_EQ(endpoint.request_count(), 1);
+  const size_t single_call_bytes = endpoint.upload_bytes();
+
+  // Later calls are answered from the cache.
+  get_balances(1);
+  EXPECT_EQ(endpoint.request_count(), 1);
+  EXPECT_EQ(endpoint.upload_bytes(), single_call_bytes);
+
+  // Switching networks drops the cache.
+  controller.SetNetwork(Network::kRinkeby);
+  get_balances(1);
+  EXPECT_EQ(endpoint.request_count(), 2);
+}
+
+TEST_F(EthJsonRpcControllerUnitTest, FallsBackWithoutBatchSupport) {
+  FakeJsonRpcEndpoint endpoint(
+      FakeJsonRpcEndpoint::BatchSupport::kUnsupported);
+  EthJsonRpcController controller(Network::kMainnet,
+                                  endpoint.shared_url_loader_factory());
+  const std::vector<std::string> addresses = {
+      "0x4e02f254184E904300e0775E4b8eeCB1",
+      "0x4e02f254184E904300e0775E4b8eeCB2"};
+
+  base::RunLoop run_loop;
+  size_t responses = 0;
+  for (const auto& address : addresses) {
+    controller.GetBalance(
+        address, base::BindLambdaForTesting(
+                     [&, address](bool status, const std::string& balance) {
+                       EXPECT_TRUE(status);
+                       EXPECT_EQ(balance, address);
+                       if (++responses == addresses.size())
+                         run_loop.Quit();
+                     }));
+  }
+  run_loop.Run();
+
+  // One rejected batch, then each call on its own.
+  EXPECT_EQ(endpoint.request_count(), 3);
+}
+
+TEST_F(EthJsonRpcControllerUnitTest, FailsCallsOfFailedBatch) {
+  FakeJsonRpcEndpoint endpoint(FakeJsonRpcEndpoint::BatchSupport::kFailing);
+  EthJsonRpcController controller(Network::kMainnet,
+                                  endpoint.shared_url_loader_factory());
+  const std::vector<std::string> addresses = {
+      "0x4e02f254184E904300e0775E4b8eeCB1",
+      "0x4e02f254184E904300e0775E4b8eeCB2"};
+
+  base::RunLoop run_loop;
+  size_t responses = 0;
+  for (const auto& address : addresses) {
+    controller.GetBalance(
+        address,
+        base::BindLambdaForTesting([&](bool status, const std::string&) {
+          EXPECT_FALSE(status);
+          if (++responses == addresses.size())
+            run_loop.Quit();
+        }));
+  }
+  run_loop.Run();
+
+  // The calls aren't resent one by one.
+  EXPECT_EQ(endpoint.request_count(), 1);
+}
+
+TEST_F(EthJsonRpcControllerUnitTest, SplitsLargeBatches) {
+  FakeJsonRpcEndpoint endpoint(FakeJsonRpcEndpoint::BatchSupport::kSupported);
+  EthJsonRpcController controller(Network::kMainnet,
+                                  endpoint.shared_url_loader_factory());
+  const size_t max_calls = EthJsonRpcController::kMaxCallsPerBatch;
+  const size_t call_count = max_calls + 5;
+
+  base::RunLoop run_loop;
+  size_t responses = 0;
+  for (size_t i = 0; i < call_count; ++i) {
+    const std::string address =
+        "0x4e02f254184E904300e0775E4b8eeC" + base::NumberToString(i);
+    controller.GetBalance(
+        address, base::BindLambdaForTesting(
+                     [&, address](bool status, const std::string& balance) {
+                       EXPECT_TRUE(status);
+                       EXPECT_EQ(balance, address);
+                       if (++responses == call_count)
+                         run_loop.Quit();
+                     }));
+  }
+  run_loop.Run();
+
+  EXPECT_EQ(endpoint.request_count(), 2);
+  EXPECT_EQ(endpoint.largest_batch(), max_calls);
+}
+
 }  // namespace brave_wallet
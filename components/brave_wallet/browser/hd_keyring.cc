@@ -27,6 +27,7 @@ void HDKeyring::ClearData() {
   root_.reset();
   master_key_.reset();
   accounts_.clear();
+  addresses_.clear();
 }
 
 void HDKeyring::ConstructRootHDKey(const std::vector<uint8_t>& seed,
@@ -57,9 +58,12 @@ std::vector<std::string> HDKeyring::GetAccounts() {
 }
 
 void HDKeyring::RemoveAccount(const std::string& address) {
-  for (size_t i = 0; i < accounts_.size(); ++i) {
+  for (size_t i = 0; i < accounts_.size();) {
     if (GetAddress(i) == address) {
       accounts_.erase(accounts_.begin() + i);
+      addresses_.erase(addresses_.begin() + i);
+    } else {
+      ++i;
     }
   }
 }
@@ -67,6 +71,13 @@ void HDKeyring::RemoveAccount(const std::string& address) {
 std::string HDKeyring::GetAddress(size_t index) {
   if (accounts_.empty() || index >= accounts_.size())
     return std::string();
+  // Computing an address takes a public key serialization and a Keccak hash,
+  // and lookups by address go through every account.
+  if (addresses_.size() < accounts_.size())
+    addresses_.resize(accounts_.size());
+  if (!addresses_[index].empty())
+    return addresses_[index];
+
   const std::vector<uint8_t> public_key =
       accounts_[index]->GetUncompressedPublicKey();
   // trim the header byte 0x04
@@ -75,7 +86,8 @@ std::string HDKeyring::GetAddress(size_t index) {
   EthAddress addr = EthAddress::FromPublicKey(pubkey_no_header);
 
   // TODO(darkdh): chain id
-  return addr.ToChecksumAddress();
+  addresses_[index] = addr.ToChecksumAddress();
+  return addresses_[index];
 }
 
 void HDKeyring::SignTransaction(const std::string& address,
@@ -51,11 +51,16 @@ class HDKeyring {
  protected:
   HDKey* GetHDKeyFromAddress(const std::string& address);
 
+  // Extended key at |hd_path|, so each account is a single derivation step.
   std::unique_ptr<HDKey> root_;
   std::unique_ptr<HDKey> master_key_;
   std::vector<std::unique_ptr<HDKey>> accounts_;
 
  private:
+  // Lazily computed address of each entry of |accounts_|. Empty entries have
+  // not been computed yet.
+  std::vector<std::string> addresses_;
+
   FRIEND_TEST_ALL_PREFIXES(HDKeyringUnitTest, ConstructRootHDKey);
   FRIEND_TEST_ALL_PREFIXES(HDKeyringUnitTest, SignMessage);
 
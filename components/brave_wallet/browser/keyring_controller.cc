@@ -5,8 +5,12 @@
 
 #include "brave/components/brave_wallet/browser/keyring_controller.h"
 
+#include <utility>
+
 #include "base/base64.h"
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/task/thread_pool.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_utils.h"
 #include "brave/components/brave_wallet/browser/hd_keyring.h"
 #include "brave/components/brave_wallet/browser/pref_names.h"
@@ -17,10 +21,53 @@ namespace brave_wallet {
 namespace {
 const size_t kSaltSize = 32;
 const size_t kNonceSize = 12;
+const size_t kPbkdf2Iterations = 100000;
+const size_t kPbkdf2KeySize = 256;
+const char kDefaultHDPath[] = "m/44'/60'/0'/0";
 
 static base::span<const uint8_t> ToSpan(base::StringPiece sp) {
   return base::as_bytes(base::make_span(sp));
 }
+
+struct UnlockResult {
+  std::unique_ptr<PasswordEncryptor> encryptor;
+  std::unique_ptr<HDKeyring> keyring;
+};
+
+// Rebuilds the default keyring from what GetResumeParams() read. Doesn't touch
+// the controller, so it can run on a worker thread. Returns an empty result if
+// |password| is wrong.
+UnlockResult ResumeDefaultKeyring(
+    const std::string& password,
+    const std::vector<uint8_t>& salt,
+    const std::vector<uint8_t>& nonce,
+    const std::vector<uint8_t>& encrypted_mnemonic,
+    size_t account_no) {
+  UnlockResult result;
+  std::unique_ptr<PasswordEncryptor> encryptor =
+      PasswordEncryptor::DeriveKeyFromPasswordUsingPbkdf2(
+          password, salt, kPbkdf2Iterations, kPbkdf2KeySize);
+  std::vector<uint8_t> mnemonic;
+  if (!encryptor ||
+      !encryptor->Decrypt(encrypted_mnemonic, nonce, &mnemonic)) {
+    return result;
+  }
+
+  const std::unique_ptr<std::vector<uint8_t>> seed =
+      MnemonicToSeed(std::string(mnemonic.begin(), mnemonic.end()), "");
+  if (!seed)
+    return result;
+  auto keyring = std::make_unique<HDKeyring>();
+  keyring->ConstructRootHDKey(*seed, kDefaultHDPath);
+  if (account_no)
+    keyring->AddAccounts(account_no);
+  // Fill the address cache here rather than on the first UI lookup.
+  keyring->GetAccounts();
+
+  result.encryptor = std::move(encryptor);
+  result.keyring = std::move(keyring);
+  return result;
+}
 }  // namespace
 
 KeyringController::KeyringController(PrefService* prefs) : prefs_(prefs) {
@@ -36,6 +83,7 @@ KeyringController::~KeyringController() {
 
 HDKeyring* KeyringController::CreateDefaultKeyring(
     const std::string& password) {
+  unlock_weak_ptr_factory_.InvalidateWeakPtrs();
   if (!CreateEncryptor(password))
     return nullptr;
 
@@ -47,24 +95,6 @@ HDKeyring* KeyringController::CreateDefaultKeyring(
   return default_keyring_.get();
 }
 
-HDKeyring* KeyringController::ResumeDefaultKeyring(
-    const std::string& password) {
-  if (!CreateEncryptor(password)) {
-    return nullptr;
-  }
-
-  const std::string mnemonic = GetMnemonicForDefaultKeyring();
-  if (mnemonic.empty() || !CreateDefaultKeyringInternal(mnemonic)) {
-    return nullptr;
-  }
-  size_t account_no =
-      (size_t)prefs_->GetInteger(kBraveWalletDefaultKeyringAccountNum);
-  if (account_no)
-    default_keyring_->AddAccounts(account_no);
-
-  return default_keyring_.get();
-}
-
 HDKeyring* KeyringController::RestoreDefaultKeyring(
     const std::string& mnemonic,
     const std::string& password) {
@@ -112,6 +142,7 @@ bool KeyringController::IsLocked() const {
 }
 
 void KeyringController::Lock() {
+  unlock_weak_ptr_factory_.InvalidateWeakPtrs();
   if (IsLocked() || !default_keyring_)
     return;
   // invalidate keyring and save account number
@@ -123,15 +154,84 @@ void KeyringController::Lock() {
 }
 
 bool KeyringController::Unlock(const std::string& password) {
-  if (!ResumeDefaultKeyring(password)) {
-    encryptor_.reset();
+  unlock_weak_ptr_factory_.InvalidateWeakPtrs();
+  std::vector<uint8_t> salt;
+  std::vector<uint8_t> nonce;
+  std::vector<uint8_t> encrypted_mnemonic;
+  size_t account_no = 0;
+  if (password.empty() ||
+      !GetResumeParams(&salt, &nonce, &encrypted_mnemonic, &account_no)) {
+    return OnDefaultKeyringResumed(nullptr, nullptr);
+  }
+
+  UnlockResult result = ResumeDefaultKeyring(password, salt, nonce,
+                                             encrypted_mnemonic, account_no);
+  return OnDefaultKeyringResumed(std::move(result.encryptor),
+                                 std::move(result.keyring));
+}
+
+void KeyringController::Unlock(const std::string& password,
+                               UnlockCallback callback) {
+  // Only the latest unlock may install its keyring.
+  unlock_weak_ptr_factory_.InvalidateWeakPtrs();
+  std::vector<uint8_t> salt;
+  std::vector<uint8_t> nonce;
+  std::vector<uint8_t> encrypted_mnemonic;
+  size_t account_no = 0;
+  if (password.empty() ||
+      !GetResumeParams(&salt, &nonce, &encrypted_mnemonic, &account_no)) {
+    std::move(callback).Run(OnDefaultKeyringResumed(nullptr, nullptr));
+    return;
+  }
+
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_BLOCKING},
+      base::BindOnce(&ResumeDefaultKeyring, password, std::move(salt),
+                     std::move(nonce), std::move(encrypted_mnemonic),
+                     account_no),
+      base::BindOnce(
+          [](base::WeakPtr<KeyringController> controller,
+             UnlockCallback callback, UnlockResult result) {
+            // The keyring was locked, reset or replaced meanwhile.
+            if (!controller) {
+              std::move(callback).Run(false);
+              return;
+            }
+            std::move(callback).Run(controller->OnDefaultKeyringResumed(
+                std::move(result.encryptor), std::move(result.keyring)));
+          },
+          unlock_weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+}
+
+bool KeyringController::GetResumeParams(
+    std::vector<uint8_t>* salt,
+    std::vector<uint8_t>* nonce,
+    std::vector<uint8_t>* encrypted_mnemonic,
+    size_t* account_no) {
+  if (!GetPrefsInBytes(kBraveWalletPasswordEncryptorSalt, salt) ||
+      !GetPrefsInBytes(kBraveWalletPasswordEncryptorNonce, nonce) ||
+      !GetPrefsInBytes(kBraveWalletEncryptedMnemonic, encrypted_mnemonic)) {
     return false;
   }
+  *account_no =
+      (size_t)prefs_->GetInteger(kBraveWalletDefaultKeyringAccountNum);
+  return true;
+}
 
+bool KeyringController::OnDefaultKeyringResumed(
+    std::unique_ptr<PasswordEncryptor> encryptor,
+    std::unique_ptr<HDKeyring> keyring) {
+  if (!encryptor || !keyring) {
+    encryptor_.reset();
+    return false;
+  }
+  encryptor_ = std::move(encryptor);
+  default_keyring_ = std::move(keyring);
   return true;
 }
 
 void KeyringController::Reset() {
+  unlock_weak_ptr_factory_.InvalidateWeakPtrs();
   prefs_->ClearPref(kBraveWalletPasswordEncryptorSalt);
   prefs_->ClearPref(kBraveWalletPasswordEncryptorNonce);
   encryptor_.reset();
@@ -182,7 +282,7 @@ bool KeyringController::CreateEncryptor(const std::string& password) {
     SetPrefsInBytes(kBraveWalletPasswordEncryptorSalt, salt);
   }
   encryptor_ = PasswordEncryptor::DeriveKeyFromPasswordUsingPbkdf2(
-      password, salt, 100000, 256);
+      password, salt, kPbkdf2Iterations, kPbkdf2KeySize);
   return encryptor_ != nullptr;
 }
 
@@ -200,7 +300,7 @@ bool KeyringController::CreateDefaultKeyringInternal(
   const std::unique_ptr<std::vector<uint8_t>> seed =
       MnemonicToSeed(mnemonic, "");
   default_keyring_ = std::make_unique<HDKeyring>();
-  default_keyring_->ConstructRootHDKey(*seed, "m/44'/60'/0'/0");
+  default_keyring_->ConstructRootHDKey(*seed, kDefaultHDPath);
 
   return true;
 }
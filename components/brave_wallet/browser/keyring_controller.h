@@ -10,7 +10,9 @@
 #include <string>
 #include <vector>
 
+#include "base/callback.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/weak_ptr.h"
 #include "brave/components/brave_wallet/browser/password_encryptor.h"
 
 class PrefService;
@@ -27,6 +29,7 @@ FORWARD_DECLARE_TEST(KeyringControllerUnitTest, CreateEncryptor);
 FORWARD_DECLARE_TEST(KeyringControllerUnitTest, CreateDefaultKeyringInternal);
 FORWARD_DECLARE_TEST(KeyringControllerUnitTest, GetMnemonicForDefaultKeyring);
 FORWARD_DECLARE_TEST(KeyringControllerUnitTest, LockAndUnlock);
+FORWARD_DECLARE_TEST(KeyringControllerUnitTest, UnlockAsyncCancelled);
 FORWARD_DECLARE_TEST(KeyringControllerUnitTest, Reset);
 
 // This class is not thread-safe and should have single owner
@@ -50,6 +53,10 @@ class KeyringController {
   bool IsLocked() const;
   void Lock();
   bool Unlock(const std::string& password);
+  // Same as above, but the key derivation and keyring reconstruction, which
+  // take hundreds of milliseconds, run on a worker thread.
+  using UnlockCallback = base::OnceCallback<void(bool success)>;
+  void Unlock(const std::string& password, UnlockCallback callback);
 
   /* TODO(darkdh): For other keyrings support
   void DeleteKeyring(size_t index);
@@ -68,6 +75,7 @@ class KeyringController {
   FRIEND_TEST_ALL_PREFIXES(KeyringControllerUnitTest,
                            GetMnemonicForDefaultKeyring);
   FRIEND_TEST_ALL_PREFIXES(KeyringControllerUnitTest, LockAndUnlock);
+  FRIEND_TEST_ALL_PREFIXES(KeyringControllerUnitTest, UnlockAsyncCancelled);
   FRIEND_TEST_ALL_PREFIXES(KeyringControllerUnitTest, Reset);
 
   bool GetPrefsInBytes(const std::string& path, std::vector<uint8_t>* bytes);
@@ -76,8 +84,15 @@ class KeyringController {
   std::vector<uint8_t> GetOrCreateNonce();
   bool CreateEncryptor(const std::string& password);
   bool CreateDefaultKeyringInternal(const std::string& mnemonic);
-  // It's used to reconstruct same default keyring between browser relaunch
-  HDKeyring* ResumeDefaultKeyring(const std::string& password);
+  // Reads what is needed to reconstruct the same default keyring between
+  // browser relaunch. Returns false if there is no keyring to resume.
+  bool GetResumeParams(std::vector<uint8_t>* salt,
+                       std::vector<uint8_t>* nonce,
+                       std::vector<uint8_t>* encrypted_mnemonic,
+                       size_t* account_no);
+  // Installs the resumed keyring, or locks the controller if resuming failed.
+  bool OnDefaultKeyringResumed(std::unique_ptr<PasswordEncryptor> encryptor,
+                               std::unique_ptr<HDKeyring> keyring);
 
   std::unique_ptr<PasswordEncryptor> encryptor_;
   std::unique_ptr<HDKeyring> default_keyring_;
@@ -87,6 +102,10 @@ class KeyringController {
 
   PrefService* prefs_;
 
+  // Invalidated whenever the keyring is locked, reset or replaced, so that an
+  // unlock still running on a worker doesn't install a stale keyring.
+  base::WeakPtrFactory<KeyringController> unlock_weak_ptr_factory_{this};
+
   KeyringController(const KeyringController&) = delete;
   KeyringController& operator=(const KeyringController&) = delete;
 };
@@ -6,6 +6,8 @@
 #include "brave/components/brave_wallet/browser/keyring_controller.h"
 
 #include "base/base64.h"
+#include "base/run_loop.h"
+#include "base/test/bind.h"
 #include "brave/components/brave_wallet/browser/hd_keyring.h"
 #include "brave/components/brave_wallet/browser/pref_names.h"
 #include "chrome/browser/profiles/profile_manager.h"
@@ -372,6 +374,90 @@ TEST_F(KeyringControllerUnitTest, LockAndUnlock) {
   EXPECT_EQ(GetPrefs()->GetInteger(kBraveWalletDefaultKeyringAccountNum), 3);
 }
 
+TEST_F(KeyringControllerUnitTest, UnlockAsync) {
+  auto unlock = [](KeyringController* controller, const std::string& password) {
+    bool result = false;
+    base::RunLoop run_loop;
+    controller->Unlock(password,
+                       base::BindLambdaForTesting([&](bool success) {
+                         result = success;
+                         run_loop.Quit();
+                       }));
+    run_loop.Run();
+    return result;
+  };
+
+  std::vector<std::string> accounts;
+  {
+    KeyringController controller(GetPrefs());
+    // Nothing to unlock yet
+    EXPECT_FALSE(unlock(&controller, "brave"));
+    HDKeyring* keyring = controller.CreateDefaultKeyring("brave");
+    ASSERT_NE(keyring, nullptr);
+    keyring->AddAccounts(3);
+    accounts = keyring->GetAccounts();
+  }
+  {
+    // KeyringController is now destructed, simlulating relaunch
+    KeyringController controller(GetPrefs());
+    EXPECT_FALSE(unlock(&controller, "brave123"));
+    EXPECT_FALSE(unlock(&controller, ""));
+    EXPECT_TRUE(controller.IsLocked());
+
+    EXPECT_TRUE(unlock(&controller, "brave"));
+    EXPECT_FALSE(controller.IsLocked());
+    ASSERT_NE(controller.GetDefaultKeyring(), nullptr);
+    EXPECT_EQ(controller.GetDefaultKeyring()->GetAccounts(), accounts);
+
+    controller.Lock();
+    EXPECT_FALSE(unlock(&controller, "brave123"));
+    EXPECT_TRUE(controller.IsLocked());
+    EXPECT_TRUE(unlock(&controller, "brave"));
+    EXPECT_EQ(controller.GetDefaultKeyring()->GetAccounts(), accounts);
+  }
+}
+
+TEST_F(KeyringControllerUnitTest, UnlockAsyncCancelled) {
+  {
+    KeyringController controller(GetPrefs());
+    ASSERT_NE(controller.CreateDefaultKeyring("brave"), nullptr);
+    controller.Lock();
+  }
+  auto unlock_then = [](KeyringController* controller,
+                        base::OnceClosure interrupt) {
+    bool result = true;
+    base::RunLoop run_loop;
+    controller->Unlock("brave", base::BindLambdaForTesting([&](bool success) {
+                         result = success;
+                         run_loop.Quit();
+                       }));
+    std::move(interrupt).Run();
+    run_loop.Run();
+    return result;
+  };
+
+  KeyringController controller(GetPrefs());
+  // Locking while the keys are being derived wins over the unlock.
+  EXPECT_FALSE(unlock_then(
+      &controller, base::BindOnce(&KeyringController::Lock,
+                                  base::Unretained(&controller))));
+  EXPECT_TRUE(controller.IsLocked());
+
+  // A newer unlock supersedes the pending one.
+  EXPECT_FALSE(unlock_then(&controller, base::BindLambdaForTesting([&]() {
+                             EXPECT_TRUE(controller.Unlock("brave"));
+                           })));
+  EXPECT_FALSE(controller.IsLocked());
+
+  // Reset must not be undone by the pending unlock.
+  controller.Lock();
+  EXPECT_FALSE(unlock_then(
+      &controller, base::BindOnce(&KeyringController::Reset,
+                                  base::Unretained(&controller))));
+  EXPECT_TRUE(controller.IsLocked());
+  EXPECT_EQ(controller.default_keyring_, nullptr);
+}
+
 TEST_F(KeyringControllerUnitTest, Reset) {
   KeyringController controller(GetPrefs());
   HDKeyring* keyring = controller.CreateDefaultKeyring("brave");
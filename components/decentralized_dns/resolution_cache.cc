@@ -0,0 +1,91 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/decentralized_dns/resolution_cache.h"
+
+#include <memory>
+
+#include "brave/components/decentralized_dns/constants.h"
+#include "content/public/browser/browser_context.h"
+
+namespace decentralized_dns {
+
+namespace {
+
+const char kResolutionCacheKey[] = "decentralized_dns_resolution_cache";
+
+// Records change rarely, but keep this short enough for updates to a name
+// to show up without restarting the browser.
+constexpr base::TimeDelta kDefaultResolutionCacheTtl =
+    base::TimeDelta::FromMinutes(5);
+
+}  // namespace
+
+ResolutionCache::ResolutionCache(base::TimeDelta ttl) : ttl_(ttl) {}
+
+ResolutionCache::~ResolutionCache() = default;
+
+// static
+ResolutionCache* ResolutionCache::GetForContext(
+    content::BrowserContext* context) {
+  auto* cache =
+      static_cast<ResolutionCache*>(context->GetUserData(kResolutionCacheKey));
+  if (!cache) {
+    // Object cleanup is handled by SupportsUserData
+    context->SetUserData(
+        kResolutionCacheKey,
+        std::make_unique<ResolutionCache>(kDefaultResolutionCacheTtl));
+    cache = static_cast<ResolutionCache*>(
+        context->GetUserData(kResolutionCacheKey));
+  }
+  return cache;
+}
+
+bool ResolutionCache::Get(Provider provider,
+                          const std::string& name,
+                          std::string* new_url_spec) {
+  auto it = entries_.find(Key(provider, name));
+  if (it == entries_.end())
+    return false;
+
+  if (base::TimeTicks::Now() >= it->second.expiration) {
+    entries_.erase(it);
+    return false;
+  }
+
+  *new_url_spec = it->second.new_url_spec;
+  return true;
+}
+
+bool ResolutionCache::AddPendingRequest(Provider provider,
+                                        const std::string& name,
+                                        ResolveCallback callback) {
+  std::vector<ResolveCallback>& callbacks =
+      pending_requests_[Key(provider, name)];
+  callbacks.push_back(std::move(callback));
+  return callbacks.size() == 1;
+}
+
+void ResolutionCache::OnResolved(Provider provider,
+                                 const std::string& name,
+                                 bool success,
+                                 const std::string& new_url_spec) {
+  const Key key(provider, name);
+  if (success)
+    entries_[key] = {new_url_spec, base::TimeTicks::Now() + ttl_};
+
+  auto it = pending_requests_.find(key);
+  if (it == pending_requests_.end())
+    return;
+
+  // Callbacks may issue new requests for the same name, which must start a
+  // new lookup or hit the cache.
+  std::vector<ResolveCallback> callbacks = std::move(it->second);
+  pending_requests_.erase(it);
+  for (auto& callback : callbacks)
+    std::move(callback).Run(success ? new_url_spec : std::string());
+}
+
+}  // namespace decentralized_dns
@@ -0,0 +1,87 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_DECENTRALIZED_DNS_RESOLUTION_CACHE_H_
+#define BRAVE_COMPONENTS_DECENTRALIZED_DNS_RESOLUTION_CACHE_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/supports_user_data.h"
+#include "base/time/time.h"
+
+namespace content {
+class BrowserContext;
+}  // namespace content
+
+namespace decentralized_dns {
+
+enum class Provider;
+
+// Per-profile cache of decentralized DNS resolutions, so that the subresources
+// of a page on a .crypto or .eth domain don't each query the Ethereum provider
+// again. Each provider always queries the same set of records, so entries are
+// keyed by (provider, name) and hold the decoded redirect target, which is
+// empty if the name has no usable records.
+class ResolutionCache : public base::SupportsUserData::Data {
+ public:
+  using ResolveCallback =
+      base::OnceCallback<void(const std::string& new_url_spec)>;
+
+  explicit ResolutionCache(base::TimeDelta ttl);
+  ~ResolutionCache() override;
+
+  ResolutionCache(const ResolutionCache&) = delete;
+  ResolutionCache& operator=(const ResolutionCache&) = delete;
+
+  static ResolutionCache* GetForContext(content::BrowserContext* context);
+
+  // Returns true and fills |new_url_spec| if there is an unexpired resolution
+  // for |name|.
+  bool Get(Provider provider,
+           const std::string& name,
+           std::string* new_url_spec);
+
+  // Queues |callback| until |name| is resolved. Returns true if no lookup is
+  // in flight yet, in which case the caller must start one and report its
+  // result through OnResolved().
+  bool AddPendingRequest(Provider provider,
+                         const std::string& name,
+                         ResolveCallback callback);
+
+  // Caches the resolution for |name| if |success| and runs the queued
+  // callbacks. Failed lookups are not cached, the callbacks get an empty
+  // |new_url_spec|.
+  void OnResolved(Provider provider,
+                  const std::string& name,
+                  bool success,
+                  const std::string& new_url_spec);
+
+  base::WeakPtr<ResolutionCache> AsWeakPtr() {
+    return weak_ptr_factory_.GetWeakPtr();
+  }
+
+ private:
+  using Key = std::pair<Provider, std::string>;
+
+  struct Entry {
+    std::string new_url_spec;
+    base::TimeTicks expiration;
+  };
+
+  const base::TimeDelta ttl_;
+  std::map<Key, Entry> entries_;
+  std::map<Key, std::vector<ResolveCallback>> pending_requests_;
+
+  base::WeakPtrFactory<ResolutionCache> weak_ptr_factory_{this};
+};
+
+}  // namespace decentralized_dns
+
+#endif  // BRAVE_COMPONENTS_DECENTRALIZED_DNS_RESOLUTION_CACHE_H_
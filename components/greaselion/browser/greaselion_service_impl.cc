@@ -6,7 +6,9 @@
 #include "brave/components/greaselion/browser/greaselion_service_impl.h"
 
 #include <stddef.h>
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -16,15 +18,19 @@
 #include "base/callback_helpers.h"
 #include "base/command_line.h"
 #include "base/feature_list.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/json/json_file_value_serializer.h"
 #include "base/one_shot_event.h"
 #include "base/sequenced_task_runner.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/post_task.h"
 #include "base/task_runner_util.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "base/version.h"
 #include "brave/components/brave_component_updater/browser/features.h"
@@ -33,6 +39,7 @@
 #include "brave/components/version_info//version_info.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "components/version_info/version_info.h"
+#include "crypto/secure_hash.h"
 #include "crypto/sha2.h"
 #include "extensions/browser/extension_registry.h"
 #include "extensions/browser/extension_system.h"
@@ -50,29 +57,162 @@ using extensions::mojom::ManifestLocation;
 namespace {
 
 constexpr char kRunAtDocumentStart[] = "document_start";
+// Converted extensions live in content-addressed subdirectories of this one,
+// so they can be reused across updates and browser restarts.
+constexpr char kConvertedExtensionsDir[] = "GreaselionExtensions";
+// Converted extensions that haven't been loaded for this long are deleted.
+constexpr base::TimeDelta kUnusedExtensionLifetime =
+    base::TimeDelta::FromDays(30);
+// Converted extensions are shared by all profiles, so they are only collected
+// once per browser process. The first service queues the cleanup ahead of any
+// load on the shared extension file task runner, so an entry another profile
+// is using is never deleted.
+bool g_unused_extensions_deleted = false;
+
+// Greaselion scripts are not signed, but the public key for an extension
+// doubles as its unique identity, and we need one of those, so we add the
+// rule name to a known Brave domain and hash the result to create a
+// public key.
+std::string GetPublicKeyForRule(const greaselion::GreaselionRule& rule) {
+  char raw[crypto::kSHA256Length] = {0};
+  std::string key;
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(brave_component_updater::kUseGoUpdateDev) &&
+      !base::FeatureList::IsEnabled(
+          brave_component_updater::kUseDevUpdaterUrl)) {
+    crypto::SHA256HashString(UPDATER_DEV_ENDPOINT + rule.name(),
+                             raw,
+                             crypto::kSHA256Length);
+  } else {
+    crypto::SHA256HashString(UPDATER_PROD_ENDPOINT + rule.name(),
+                             raw,
+                             crypto::kSHA256Length);
+  }
+  base::Base64Encode(base::StringPiece(raw, crypto::kSHA256Length), &key);
+  return key;
+}
+
+void UpdateHash(crypto::SecureHash* hash, base::StringPiece value) {
+  hash->Update(value.data(), value.size());
+  // Separate fields so that their boundaries are part of the hash.
+  hash->Update("", 1);
+}
+
+bool UpdateHashWithFile(crypto::SecureHash* hash,
+                        const base::FilePath& path,
+                        const base::FilePath& name) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents)) {
+    LOG(ERROR) << "Could not read Greaselion file at path: "
+               << path.LossyDisplayName();
+    return false;
+  }
+  UpdateHash(hash, name.AsUTF8Unsafe());
+  UpdateHash(hash, contents);
+  return true;
+}
+
+// Returns a key identifying the extension that
+// ConvertGreaselionRuleToExtensionOnTaskRunner() would generate for |rule|,
+// or an empty string if the rule's files can't be read.
+//
+// NOTE: This function does file IO and should not be called on the UI thread.
+std::string ComputeRuleKey(const greaselion::GreaselionRule& rule,
+                           const base::Version& browser_version) {
+  std::unique_ptr<crypto::SecureHash> hash =
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256);
+  UpdateHash(hash.get(), browser_version.GetString());
+  UpdateHash(hash.get(), rule.name());
+  UpdateHash(hash.get(), GetPublicKeyForRule(rule));
+  UpdateHash(hash.get(), rule.run_at());
+  for (const std::string& url_pattern : rule.url_patterns())
+    UpdateHash(hash.get(), url_pattern);
+  for (const base::FilePath& script : rule.scripts()) {
+    if (!UpdateHashWithFile(hash.get(), script, script.BaseName()))
+      return std::string();
+  }
+
+  if (!rule.messages().empty()) {
+    std::vector<base::FilePath> messages;
+    base::FileEnumerator enumerator(rule.messages(), true,
+                                    base::FileEnumerator::FILES);
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      messages.push_back(path);
+    }
+    std::sort(messages.begin(), messages.end());
+    for (const base::FilePath& path : messages) {
+      base::FilePath relative_path;
+      rule.messages().AppendRelativePath(path, &relative_path);
+      if (!UpdateHashWithFile(hash.get(), path, relative_path))
+        return std::string();
+    }
+  }
+
+  uint8_t digest[crypto::kSHA256Length];
+  hash->Finish(digest, sizeof(digest));
+  return base::ToLowerASCII(base::HexEncode(digest, sizeof(digest)));
+}
+
+std::vector<std::string> ComputeRuleKeysOnTaskRunner(
+    const std::vector<greaselion::GreaselionRule>& rules,
+    const base::Version& browser_version) {
+  std::vector<std::string> keys;
+  keys.reserve(rules.size());
+  for (const greaselion::GreaselionRule& rule : rules)
+    keys.push_back(ComputeRuleKey(rule, browser_version));
+  return keys;
+}
+
+scoped_refptr<Extension> LoadConvertedExtension(
+    const base::FilePath& extension_dir) {
+  std::string error;
+  scoped_refptr<Extension> extension = extensions::file_util::LoadExtension(
+      extension_dir, ManifestLocation::kComponent, Extension::NO_FLAGS,
+      &error);
+  if (!extension.get()) {
+    LOG(ERROR) << "Could not load Greaselion extension";
+    LOG(ERROR) << error;
+  }
+  return extension;
+}
 
 // Wraps a Greaselion rule in a component. The component is stored as
-// an unpacked extension in the user data dir. Returns a valid
-// extension that the caller should take ownership of, or nullptr.
+// an unpacked extension in the user data dir, under a directory named after
+// |key|. If that directory already exists it is loaded as is. Returns a valid
+// extension, or nullptr.
 //
 // NOTE: This function does file IO and should not be called on the UI thread.
-// NOTE: The caller takes ownership of the directory at extension->path() on the
-// returned object.
-base::Optional<greaselion::GreaselionServiceImpl::GreaselionConvertedExtension>
-ConvertGreaselionRuleToExtensionOnTaskRunner(
+scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
     const greaselion::GreaselionRule& rule,
+    const std::string& key,
     const base::FilePath& install_dir) {
+  const base::FilePath extension_dir =
+      install_dir.AppendASCII(kConvertedExtensionsDir).AppendASCII(key);
+  if (base::PathExists(extension_dir)) {
+    scoped_refptr<Extension> extension = LoadConvertedExtension(extension_dir);
+    if (extension) {
+      // Keep the cached extension from being garbage collected.
+      const base::Time now = base::Time::Now();
+      base::TouchFile(extension_dir, now, now);
+      return extension;
+    }
+    // Most likely left over from an interrupted conversion, start over.
+    base::DeletePathRecursively(extension_dir);
+  }
+
   base::FilePath install_temp_dir =
       extensions::file_util::GetInstallTempDir(install_dir);
   if (install_temp_dir.empty()) {
     LOG(ERROR) << "Could not get path to profile temp directory";
-    return base::nullopt;
+    return nullptr;
   }
 
   base::ScopedTempDir temp_dir;
   if (!temp_dir.CreateUniqueTempDirUnderPath(install_temp_dir)) {
     LOG(ERROR) << "Could not create Greaselion temp directory";
-    return base::nullopt;
+    return nullptr;
   }
 
   // Create the manifest
@@ -82,33 +222,11 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
   // see kModernManifestVersion in src/extensions/common/extension.cc
   root->SetIntPath(extensions::manifest_keys::kManifestVersion, 2);
 
-  // Create the public key.
-  // Greaselion scripts are not signed, but the public key for an extension
-  // doubles as its unique identity, and we need one of those, so we add the
-  // rule name to a known Brave domain and hash the result to create a
-  // public key.
-  char raw[crypto::kSHA256Length] = {0};
-  std::string key;
-  std::string script_name = rule.name();
-  const base::CommandLine& command_line =
-      *base::CommandLine::ForCurrentProcess();
-  if (!command_line.HasSwitch(brave_component_updater::kUseGoUpdateDev) &&
-      !base::FeatureList::IsEnabled(
-          brave_component_updater::kUseDevUpdaterUrl)) {
-    crypto::SHA256HashString(UPDATER_DEV_ENDPOINT + script_name,
-                             raw,
-                             crypto::kSHA256Length);
-  } else {
-    crypto::SHA256HashString(UPDATER_PROD_ENDPOINT + script_name,
-                             raw,
-                             crypto::kSHA256Length);
-  }
-  base::Base64Encode(base::StringPiece(raw, crypto::kSHA256Length), &key);
-
-  root->SetStringPath(extensions::manifest_keys::kName, script_name);
+  root->SetStringPath(extensions::manifest_keys::kName, rule.name());
   root->SetStringPath(extensions::manifest_keys::kVersion, "1.0");
   root->SetStringPath(extensions::manifest_keys::kDescription, "");
-  root->SetStringPath(extensions::manifest_keys::kPublicKey, key);
+  root->SetStringPath(extensions::manifest_keys::kPublicKey,
+                      GetPublicKeyForRule(rule));
   root->SetStringPath("incognito",
                       extensions::manifest_values::kIncognitoNotAllowed);
 
@@ -150,7 +268,7 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
   // files to disk.
   if (!serializer.Serialize(*root)) {
     LOG(ERROR) << "Could not write Greaselion manifest";
-    return base::nullopt;
+    return nullptr;
   }
 
   // Copy the messages directory to our extension directory.
@@ -160,7 +278,7 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
             temp_dir.GetPath().AppendASCII("_locales"), true)) {
       LOG(ERROR) << "Could not copy Greaselion messages directory at path: "
                  << rule.messages().LossyDisplayName();
-      return base::nullopt;
+      return nullptr;
     }
   }
 
@@ -170,24 +288,52 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
                         temp_dir.GetPath().Append(script.BaseName()))) {
       LOG(ERROR) << "Could not copy Greaselion script at path: "
           << script.LossyDisplayName();
-      return base::nullopt;
+      return nullptr;
     }
   }
 
-  std::string error;
-  scoped_refptr<Extension> extension = extensions::file_util::LoadExtension(
-      temp_dir.GetPath(), ManifestLocation::kComponent, Extension::NO_FLAGS,
-      &error);
-  if (!extension.get()) {
-    LOG(ERROR) << "Could not load Greaselion extension";
-    LOG(ERROR) << error;
-    return base::nullopt;
+  // Only publish the extension once it is complete, so that an interrupted
+  // conversion never leaves a partial entry behind.
+  if (!base::CreateDirectory(extension_dir.DirName()) ||
+      !base::Move(temp_dir.GetPath(), extension_dir)) {
+    LOG(ERROR) << "Could not move Greaselion extension to path: "
+               << extension_dir.LossyDisplayName();
+    return nullptr;
   }
+  ignore_result(temp_dir.Take());
 
-  // Take ownership of this temporary directory so it's deleted when
-  // the service exits
-  return std::make_pair(extension, std::move(temp_dir));
+  return LoadConvertedExtension(extension_dir);
+}
+
+// Returns true if |name| has the format of the keys returned by
+// ComputeRuleKey().
+bool IsRuleKey(const std::string& name) {
+  return name.size() == 2 * crypto::kSHA256Length &&
+         std::all_of(name.begin(), name.end(), [](char c) {
+           return base::IsAsciiDigit(c) || (c >= 'a' && c <= 'f');
+         });
+}
+
+// Deletes converted extensions that haven't been loaded for a while, e.g.
+// those for rules that were since removed or updated. Directories that
+// weren't created by ConvertGreaselionRuleToExtensionOnTaskRunner() are left
+// alone.
+//
+// NOTE: This function does file IO and should not be called on the UI thread.
+void DeleteUnusedExtensionsOnTaskRunner(const base::FilePath& install_dir) {
+  const base::Time cutoff = base::Time::Now() - kUnusedExtensionLifetime;
+  base::FileEnumerator enumerator(
+      install_dir.AppendASCII(kConvertedExtensionsDir), false,
+      base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    if (!IsRuleKey(path.BaseName().MaybeAsASCII()))
+      continue;
+    if (enumerator.GetInfo().GetLastModifiedTime() < cutoff)
+      base::DeletePathRecursively(path);
+  }
 }
+
 }  // namespace
 
 namespace greaselion {
@@ -216,6 +362,12 @@ GreaselionServiceImpl::GreaselionServiceImpl(
     state_[static_cast<GreaselionFeature>(i)] = false;
   // Static-value features
   state_[GreaselionFeature::SUPPORTS_MINIMUM_BRAVE_VERSION] = true;
+  if (!g_unused_extensions_deleted) {
+    g_unused_extensions_deleted = true;
+    task_runner_->PostTask(FROM_HERE,
+                           base::BindOnce(&DeleteUnusedExtensionsOnTaskRunner,
+                                          install_directory_));
+  }
 }
 
 GreaselionServiceImpl::~GreaselionServiceImpl() {
@@ -238,74 +390,91 @@ void GreaselionServiceImpl::UpdateInstalledExtensions() {
     return;
   }
   update_in_progress_ = true;
-  if (greaselion_extensions_.empty()) {
-    // No Greaselion extensions are currently installed, so we can move on to
-    // the install phase immediately.
-    CreateAndInstallExtensions();
-    return;
+
+  std::vector<GreaselionRule> rules;
+  for (const std::unique_ptr<GreaselionRule>& rule :
+       *download_service_->rules()) {
+    if (rule->Matches(state_, browser_version_) &&
+        rule->has_unknown_preconditions() == false) {
+      rules.emplace_back(*rule);
+    }
   }
 
-  // Make a copy of greaselion_extensions_ to iterate while the original vector
-  // changes.
-  std::vector<extensions::ExtensionId> extensions = greaselion_extensions_;
-  for (auto id : extensions) {
-    // We need to unload all the Greaselion extensions that are already
-    // installed. OnExtensionUnloaded will be called on each extension, where we
-    // will update the greaselion_extensions_ set. Once it's empty, that
-    // callback will call CreateAndInstallExtensions().
+  // Rule contents are hashed on the extension file task runner, which was
+  // passed in in the constructor, so that only extensions whose rule stopped
+  // matching or changed need to be touched.
+  base::PostTaskAndReplyWithResult(
+      task_runner_.get(), FROM_HERE,
+      base::BindOnce(&ComputeRuleKeysOnTaskRunner, rules, browser_version_),
+      base::BindOnce(&GreaselionServiceImpl::OnRuleKeysComputed,
+                     weak_factory_.GetWeakPtr(), rules));
+}
+
+void GreaselionServiceImpl::OnRuleKeysComputed(
+    std::vector<GreaselionRule> rules,
+    std::vector<std::string> keys) {
+  DCHECK(update_in_progress_);
+  DCHECK_EQ(rules.size(), keys.size());
+
+  // Unload the extensions that are no longer wanted. Extensions for rules
+  // which are unchanged stay installed.
+  const std::set<std::string> wanted_keys(keys.begin(), keys.end());
+  for (auto it = installed_extensions_.begin();
+       it != installed_extensions_.end();) {
+    if (wanted_keys.count(it->first)) {
+      ++it;
+      continue;
+    }
+    const extensions::ExtensionId id = it->second;
+    it = installed_extensions_.erase(it);
+    greaselion_extensions_.erase(std::remove(greaselion_extensions_.begin(),
+                                             greaselion_extensions_.end(), id),
+                                 greaselion_extensions_.end());
     extension_service_->UnloadExtension(
         id, extensions::UnloadedExtensionReason::UPDATE);
   }
-}
 
-void GreaselionServiceImpl::CreateAndInstallExtensions() {
-  DCHECK(greaselion_extensions_.empty());
-  DCHECK(update_in_progress_);
   all_rules_installed_successfully_ = true;
   pending_installs_ = 0;
-  std::vector<std::unique_ptr<GreaselionRule>>* rules =
-      download_service_->rules();
-  for (const std::unique_ptr<GreaselionRule>& rule : *rules) {
-    if (rule->Matches(state_, browser_version_) &&
-        rule->has_unknown_preconditions() == false) {
-      pending_installs_ += 1;
+  for (size_t i = 0; i < rules.size(); i++) {
+    if (installed_extensions_.count(keys[i]))
+      continue;
+    if (keys[i].empty()) {
+      all_rules_installed_successfully_ = false;
+      LOG(ERROR) << "Could not read Greaselion script";
+      continue;
     }
+    // Convert script file to component extension, or reuse the one converted
+    // earlier. This must run on extension file task runner.
+    pending_installs_ += 1;
+    base::PostTaskAndReplyWithResult(
+        task_runner_.get(), FROM_HERE,
+        base::BindOnce(&ConvertGreaselionRuleToExtensionOnTaskRunner,
+                       rules[i], keys[i], install_directory_),
+        base::BindOnce(&GreaselionServiceImpl::PostConvert,
+                       weak_factory_.GetWeakPtr(), keys[i]));
   }
   if (!pending_installs_) {
-    // no rules match, nothing else to do
+    // nothing changed, or nothing else to do
     MaybeNotifyObservers();
-    return;
-  }
-  for (const std::unique_ptr<GreaselionRule>& rule : *rules) {
-    if (rule->Matches(state_, browser_version_) &&
-        rule->has_unknown_preconditions() == false) {
-      // Convert script file to component extension. This must run on extension
-      // file task runner, which was passed in in the constructor.
-      GreaselionRule rule_copy(*rule);
-      base::PostTaskAndReplyWithResult(
-          task_runner_.get(), FROM_HERE,
-          base::BindOnce(&ConvertGreaselionRuleToExtensionOnTaskRunner,
-                         rule_copy, install_directory_),
-          base::BindOnce(&GreaselionServiceImpl::PostConvert,
-                         weak_factory_.GetWeakPtr()));
-    }
   }
 }
 
 void GreaselionServiceImpl::PostConvert(
-    base::Optional<GreaselionConvertedExtension> converted_extension) {
-  if (!converted_extension) {
+    const std::string& key,
+    scoped_refptr<extensions::Extension> extension) {
+  if (!extension) {
     all_rules_installed_successfully_ = false;
     pending_installs_ -= 1;
     MaybeNotifyObservers();
     LOG(ERROR) << "Could not load Greaselion script";
   } else {
-    greaselion_extensions_.push_back(converted_extension->first->id());
-    extension_dirs_.push_back(std::move(converted_extension->second));
+    installed_extensions_[key] = extension->id();
+    greaselion_extensions_.push_back(extension->id());
     extension_system_->ready().Post(
-        FROM_HERE, base::BindOnce(&GreaselionServiceImpl::Install,
-                                  weak_factory_.GetWeakPtr(),
-                                  std::move(converted_extension->first)));
+        FROM_HERE,
+        base::BindOnce(&GreaselionServiceImpl::Install,
+                       weak_factory_.GetWeakPtr(), std::move(extension)));
   }
 }
 
@@ -335,13 +504,17 @@ void GreaselionServiceImpl::OnExtensionUnloaded(
   auto index = std::find(greaselion_extensions_.begin(),
                          greaselion_extensions_.end(), extension->id());
   if (index == greaselion_extensions_.end()) {
-    // not one of ours
+    // not one of ours, or unloaded by OnRuleKeysComputed()
     return;
   }
   greaselion_extensions_.erase(index);
-  if (update_in_progress_ && greaselion_extensions_.empty()) {
-    // It's time!
-    CreateAndInstallExtensions();
+  // Unloaded from elsewhere, make sure the next update installs it again.
+  for (auto it = installed_extensions_.begin();
+       it != installed_extensions_.end(); ++it) {
+    if (it->second == extension->id()) {
+      installed_extensions_.erase(it);
+      break;
+    }
   }
 }
 
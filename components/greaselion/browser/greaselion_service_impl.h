@@ -13,7 +13,6 @@
 #include <vector>
 
 #include "base/files/file_path.h"
-#include "base/files/scoped_temp_dir.h"
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "base/path_service.h"
@@ -36,6 +35,7 @@ class ExtensionSystem;
 namespace greaselion {
 
 class GreaselionDownloadService;
+class GreaselionRule;
 
 class GreaselionServiceImpl : public GreaselionService {
  public:
@@ -63,14 +63,12 @@ class GreaselionServiceImpl : public GreaselionService {
                            const extensions::Extension* extension,
                            extensions::UnloadedExtensionReason reason) override;
 
-  using GreaselionConvertedExtension =
-      std::pair<scoped_refptr<extensions::Extension>, base::ScopedTempDir>;
-
  private:
   void SetBrowserVersionForTesting(const base::Version& version) override;
-  void CreateAndInstallExtensions();
-  void PostConvert(
-      base::Optional<GreaselionConvertedExtension> converted_extension);
+  void OnRuleKeysComputed(std::vector<GreaselionRule> rules,
+                          std::vector<std::string> keys);
+  void PostConvert(const std::string& key,
+                   scoped_refptr<extensions::Extension> extension);
   void Install(scoped_refptr<extensions::Extension> extension);
   void MaybeNotifyObservers();
 
@@ -87,7 +85,9 @@ class GreaselionServiceImpl : public GreaselionService {
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
   base::ObserverList<Observer> observers_;
   std::vector<extensions::ExtensionId> greaselion_extensions_;
-  std::vector<base::ScopedTempDir> extension_dirs_;
+  // Installed extensions, keyed by the hash of the rule they were converted
+  // from.
+  std::map<std::string, extensions::ExtensionId> installed_extensions_;
   base::Version browser_version_;
   base::WeakPtrFactory<GreaselionServiceImpl> weak_factory_;
 
@@ -13,6 +13,7 @@
 #include "base/strings/strcat.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
 #include "base/task_runner_util.h"
@@ -55,6 +56,17 @@ std::string TimeFormatDate(const base::Time& time) {
                             exploded_time.month, exploded_time.day_of_month);
 }
 
+// Returns true if the request completed with HTTP 200.
+bool IsRequestSucceeded(const network::SimpleURLLoader* url_loader,
+                        int* error_code,
+                        int* response_code) {
+  *error_code = url_loader->NetError();
+  *response_code = -1;
+  if (url_loader->ResponseInfo() && url_loader->ResponseInfo()->headers)
+    *response_code = url_loader->ResponseInfo()->headers->response_code();
+  return *error_code == net::OK && *response_code == net::HTTP_OK;
+}
+
 }  // namespace
 
 namespace ipfs {
@@ -147,6 +159,9 @@ void IpfsImportWorkerBase::UploadData(
 
   DCHECK(!url_loader_);
   url_loader_ = CreateURLLoader(url, "POST", std::move(request));
+  url_loader_->SetOnUploadProgressCallback(base::BindRepeating(
+      &IpfsImportWorkerBase::OnUploadProgress, weak_factory_.GetWeakPtr()));
+  upload_start_time_ = base::TimeTicks::Now();
 
   url_loader_->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
       url_loader_factory_.get(),
@@ -154,6 +169,12 @@ void IpfsImportWorkerBase::UploadData(
                      weak_factory_.GetWeakPtr()));
 }
 
+void IpfsImportWorkerBase::OnUploadProgress(uint64_t position,
+                                            uint64_t total) {
+  uploaded_bytes_ = position;
+  VLOG(2) << "Import upload progress: " << position << "/" << total;
+}
+
 bool IpfsImportWorkerBase::ParseResponseBody(const std::string& response_body,
                                              ipfs::ImportedData* data) {
   DCHECK(data);
@@ -178,21 +199,27 @@ bool IpfsImportWorkerBase::ParseResponseBody(const std::string& response_body,
 
 void IpfsImportWorkerBase::OnImportAddComplete(
     std::unique_ptr<std::string> response_body) {
-  int error_code = url_loader_->NetError();
+  int error_code = net::OK;
   int response_code = -1;
-  if (url_loader_->ResponseInfo() && url_loader_->ResponseInfo()->headers)
-    response_code = url_loader_->ResponseInfo()->headers->response_code();
-
-  bool success = (error_code == net::OK && response_code == net::HTTP_OK);
+  bool success =
+      IsRequestSucceeded(url_loader_.get(), &error_code, &response_code);
   if (success) {
     success = ParseResponseBody(*response_body, data_.get());
   }
   url_loader_.reset();
-  if (success && !data_->hash.empty()) {
-    CreateBraveDirectory();
+  if (!success || data_->hash.empty()) {
+    NotifyImportCompleted(IPFS_IMPORT_ERROR_ADD_FAILED);
     return;
   }
-  NotifyImportCompleted(IPFS_IMPORT_ERROR_ADD_FAILED);
+
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - upload_start_time_;
+  VLOG(1) << "Imported " << uploaded_bytes_ << " bytes in " << elapsed
+          << (elapsed.is_zero()
+                  ? std::string()
+                  : base::StringPrintf(" (%.2f MB/s)",
+                                       uploaded_bytes_ / (1024.0 * 1024.0) /
+                                           elapsed.InSecondsF()));
+  CreateBraveDirectory();
 }
 
 void IpfsImportWorkerBase::CreateBraveDirectory() {
@@ -214,18 +241,20 @@ void IpfsImportWorkerBase::CreateBraveDirectory() {
 void IpfsImportWorkerBase::OnImportDirectoryCreated(
     const std::string& directory,
     std::unique_ptr<std::string> response_body) {
-  int error_code = url_loader_->NetError();
+  int error_code = net::OK;
   int response_code = -1;
-  if (url_loader_->ResponseInfo() && url_loader_->ResponseInfo()->headers)
-    response_code = url_loader_->ResponseInfo()->headers->response_code();
+  bool success =
+      IsRequestSucceeded(url_loader_.get(), &error_code, &response_code);
   url_loader_.reset();
-  bool success = (error_code == net::OK && response_code == net::HTTP_OK);
-  if (success) {
-    data_->directory = directory;
-    CopyFilesToBraveDirectory();
+  if (!success) {
+    NotifyImportCompleted(IPFS_IMPORT_ERROR_MKDIR_FAILED);
     return;
   }
-  NotifyImportCompleted(IPFS_IMPORT_ERROR_MKDIR_FAILED);
+  data_->directory = directory;
+  CopyFilesToBraveDirectory();
+  // Publishing only needs the content hash, so it runs alongside the copy.
+  if (!key_to_publish_.empty())
+    PublishContent();
 }
 
 void IpfsImportWorkerBase::CopyFilesToBraveDirectory() {
@@ -245,18 +274,20 @@ void IpfsImportWorkerBase::CopyFilesToBraveDirectory() {
 
 void IpfsImportWorkerBase::OnImportFilesMoved(
     std::unique_ptr<std::string> response_body) {
-  int error_code = url_loader_->NetError();
+  int error_code = net::OK;
   int response_code = -1;
-  if (url_loader_->ResponseInfo() && url_loader_->ResponseInfo()->headers)
-    response_code = url_loader_->ResponseInfo()->headers->response_code();
+  bool success =
+      IsRequestSucceeded(url_loader_.get(), &error_code, &response_code);
   url_loader_.reset();
-  bool success = (error_code == net::OK && response_code == net::HTTP_OK);
   if (!success) {
     VLOG(1) << "error_code:" << error_code << " response_code:" << response_code
             << " response_body:" << *response_body;
   }
-  if (!data_->hash.empty() && !key_to_publish_.empty()) {
-    PublishContent();
+  // When publishing, the publish result is reported. The copy fails if the
+  // content was already imported on the same day.
+  if (!key_to_publish_.empty()) {
+    if (!publish_url_loader_)
+      NotifyImportCompleted(publish_state_);
     return;
   }
   NotifyImportCompleted(success ? IPFS_IMPORT_SUCCESS
@@ -264,14 +295,14 @@ void IpfsImportWorkerBase::OnImportFilesMoved(
 }
 
 void IpfsImportWorkerBase::PublishContent() {
-  DCHECK(!url_loader_);
+  DCHECK(!publish_url_loader_);
   std::string from = "/ipfs/" + data_->hash;
   GURL url = net::AppendQueryParameter(
       server_endpoint_.Resolve(kAPIPublishNameEndpoint), "arg", from);
   url = net::AppendQueryParameter(url, "key", key_to_publish_);
 
-  url_loader_ = CreateURLLoader(url, "POST");
-  url_loader_->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
+  publish_url_loader_ = CreateURLLoader(url, "POST");
+  publish_url_loader_->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
       url_loader_factory_.get(),
       base::BindOnce(&IpfsImportWorkerBase::OnContentPublished,
                      base::Unretained(this)));
@@ -279,12 +310,11 @@ void IpfsImportWorkerBase::PublishContent() {
 
 void IpfsImportWorkerBase::OnContentPublished(
     std::unique_ptr<std::string> response_body) {
-  int error_code = url_loader_->NetError();
+  int error_code = net::OK;
   int response_code = -1;
-  if (url_loader_->ResponseInfo() && url_loader_->ResponseInfo()->headers)
-    response_code = url_loader_->ResponseInfo()->headers->response_code();
-  url_loader_.reset();
-  bool success = (error_code == net::OK && response_code == net::HTTP_OK);
+  bool success = IsRequestSucceeded(publish_url_loader_.get(), &error_code,
+                                    &response_code);
+  publish_url_loader_.reset();
   if (success)
     data_->published_key = key_to_publish_;
   if (!success) {
@@ -292,8 +322,12 @@ void IpfsImportWorkerBase::OnContentPublished(
             << " response_body:" << *response_body;
   }
 
-  NotifyImportCompleted(success ? IPFS_IMPORT_SUCCESS
-                                : IPFS_IMPORT_ERROR_PUBLISH_FAILED);
+  publish_state_ =
+      success ? IPFS_IMPORT_SUCCESS : IPFS_IMPORT_ERROR_PUBLISH_FAILED;
+  // Wait for the copy to finish.
+  if (url_loader_)
+    return;
+  NotifyImportCompleted(publish_state_);
 }
 
 void IpfsImportWorkerBase::NotifyImportCompleted(ipfs::ImportState state) {
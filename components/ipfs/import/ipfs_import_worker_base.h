@@ -16,6 +16,7 @@
 #include "base/containers/queue.h"
 #include "base/files/file_util.h"
 #include "base/memory/scoped_refptr.h"
+#include "base/time/time.h"
 #include "brave/components/ipfs/import/imported_data.h"
 #include "brave/components/ipfs/ipfs_network_utils.h"
 #include "components/version_info/channel.h"
@@ -48,6 +49,8 @@ namespace ipfs {
 //   3. Creates target directory for import using IPFS api(/api/v0/files/mkdir)
 //   4. Moves objects to target directory using IPFS api(/api/v0/files/cp)
 //   5. Publishes objects under passed IPNS key(/api/v0/name/publish)
+// Steps 4 and 5 run concurrently once the target directory exists. When a key
+// is passed the result of publishing is reported.
 class IpfsImportWorkerBase {
  public:
   IpfsImportWorkerBase(content::BrowserContext* context,
@@ -75,6 +78,7 @@ class IpfsImportWorkerBase {
   void UploadData(std::unique_ptr<network::ResourceRequest> request);
 
   void OnImportAddComplete(std::unique_ptr<std::string> response_body);
+  void OnUploadProgress(uint64_t position, uint64_t total);
 
   void CreateBraveDirectory();
   void OnImportDirectoryCreated(const std::string& directory,
@@ -90,6 +94,10 @@ class IpfsImportWorkerBase {
 
   scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
   std::unique_ptr<network::SimpleURLLoader> url_loader_;
+  std::unique_ptr<network::SimpleURLLoader> publish_url_loader_;
+  ipfs::ImportState publish_state_ = IPFS_IMPORT_SUCCESS;
+  base::TimeTicks upload_start_time_;
+  uint64_t uploaded_bytes_ = 0;
   GURL server_endpoint_;
   std::string key_to_publish_;
   content::BrowserContext* browser_context_ = nullptr;
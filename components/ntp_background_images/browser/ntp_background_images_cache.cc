@@ -0,0 +1,136 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ntp_background_images/browser/ntp_background_images_cache.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/task/post_task.h"
+#include "base/task/thread_pool.h"
+
+namespace ntp_background_images {
+
+namespace {
+
+// Enough for a few sponsored wallpapers and their logos.
+constexpr size_t kMaxCacheSize = 16 * 1024 * 1024;
+
+scoped_refptr<base::RefCountedMemory> ReadImageFile(
+    const base::FilePath& path) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return nullptr;
+  return base::RefCountedString::TakeString(&contents);
+}
+
+}  // namespace
+
+NTPBackgroundImagesCache::NTPBackgroundImagesCache()
+    : memory_pressure_listener_(std::make_unique<base::MemoryPressureListener>(
+          FROM_HERE,
+          base::BindRepeating(&NTPBackgroundImagesCache::OnMemoryPressure,
+                              base::Unretained(this)))) {}
+
+NTPBackgroundImagesCache::~NTPBackgroundImagesCache() = default;
+
+void NTPBackgroundImagesCache::GetImage(const base::FilePath& image_file_path,
+                                        GotImageCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  auto it = index_.find(image_file_path);
+  if (it != index_.end()) {
+    entries_.splice(entries_.begin(), entries_, it->second);
+    std::move(callback).Run(it->second->second);
+    return;
+  }
+
+  auto result = pending_reads_.emplace(image_file_path,
+                                       std::vector<GotImageCallback>());
+  result.first->second.push_back(std::move(callback));
+  // Otherwise the file is already being read.
+  if (result.second)
+    ReadImage(image_file_path);
+}
+
+void NTPBackgroundImagesCache::Prefetch(const base::FilePath& image_file_path) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (image_file_path.empty() || index_.count(image_file_path))
+    return;
+
+  if (pending_reads_
+          .emplace(image_file_path, std::vector<GotImageCallback>())
+          .second) {
+    ReadImage(image_file_path);
+  }
+}
+
+void NTPBackgroundImagesCache::Clear() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  entries_.clear();
+  index_.clear();
+  total_size_ = 0;
+  generation_++;
+}
+
+void NTPBackgroundImagesCache::ReadImage(
+    const base::FilePath& image_file_path) {
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&ReadImageFile, image_file_path),
+      base::BindOnce(&NTPBackgroundImagesCache::OnImageRead,
+                     weak_factory_.GetWeakPtr(), image_file_path,
+                     generation_));
+}
+
+void NTPBackgroundImagesCache::OnImageRead(
+    const base::FilePath& image_file_path,
+    uint64_t generation,
+    scoped_refptr<base::RefCountedMemory> image) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  auto it = pending_reads_.find(image_file_path);
+  DCHECK(it != pending_reads_.end());
+  std::vector<GotImageCallback> callbacks = std::move(it->second);
+  pending_reads_.erase(it);
+
+  if (image && generation == generation_)
+    Insert(image_file_path, image);
+
+  for (auto& callback : callbacks)
+    std::move(callback).Run(image);
+}
+
+void NTPBackgroundImagesCache::Insert(
+    const base::FilePath& image_file_path,
+    scoped_refptr<base::RefCountedMemory> image) {
+  // Files that would evict everything else aren't worth keeping.
+  if (image->size() > kMaxCacheSize / 2)
+    return;
+
+  DCHECK(!index_.count(image_file_path));
+  total_size_ += image->size();
+  entries_.emplace_front(image_file_path, std::move(image));
+  index_[image_file_path] = entries_.begin();
+
+  while (total_size_ > kMaxCacheSize) {
+    const Entry& oldest = entries_.back();
+    total_size_ -= oldest.second->size();
+    index_.erase(oldest.first);
+    entries_.pop_back();
+  }
+}
+
+void NTPBackgroundImagesCache::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+    return;
+  Clear();
+}
+
+}  // namespace ntp_background_images
@@ -0,0 +1,81 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_BACKGROUND_IMAGES_CACHE_H_
+#define BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_BACKGROUND_IMAGES_CACHE_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+
+namespace ntp_background_images {
+
+// Keeps recently served wallpaper and logo files in memory so that opening
+// new tabs doesn't read multi-megabyte images from disk every time. Files are
+// read on the thread pool and handed out as the same RefCountedMemory, without
+// copying. Concurrent requests for a file share one read. The least recently
+// used files are evicted above |kMaxCacheSize|, and everything is dropped on
+// memory pressure or when the component data changes.
+class NTPBackgroundImagesCache {
+ public:
+  // Called with null if the file couldn't be read.
+  using GotImageCallback =
+      base::OnceCallback<void(scoped_refptr<base::RefCountedMemory>)>;
+
+  NTPBackgroundImagesCache();
+  ~NTPBackgroundImagesCache();
+
+  NTPBackgroundImagesCache(const NTPBackgroundImagesCache&) = delete;
+  NTPBackgroundImagesCache& operator=(const NTPBackgroundImagesCache&) = delete;
+
+  // Runs |callback| synchronously on a cache hit.
+  void GetImage(const base::FilePath& image_file_path,
+                GotImageCallback callback);
+  // Loads |image_file_path| in the background if it isn't cached yet.
+  void Prefetch(const base::FilePath& image_file_path);
+  void Clear();
+
+  size_t size_for_testing() const { return total_size_; }
+
+ private:
+  using Entry =
+      std::pair<base::FilePath, scoped_refptr<base::RefCountedMemory>>;
+
+  void ReadImage(const base::FilePath& image_file_path);
+  void OnImageRead(const base::FilePath& image_file_path,
+                   uint64_t generation,
+                   scoped_refptr<base::RefCountedMemory> image);
+  void Insert(const base::FilePath& image_file_path,
+              scoped_refptr<base::RefCountedMemory> image);
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  // Most recently used entries first.
+  std::list<Entry> entries_;
+  std::map<base::FilePath, std::list<Entry>::iterator> index_;
+  size_t total_size_ = 0;
+  // Reads in flight and the requests waiting for them.
+  std::map<base::FilePath, std::vector<GotImageCallback>> pending_reads_;
+  // Bumped by Clear() so reads started before it aren't cached.
+  uint64_t generation_ = 0;
+
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<NTPBackgroundImagesCache> weak_factory_{this};
+};
+
+}  // namespace ntp_background_images
+
+#endif  // BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_BACKGROUND_IMAGES_CACHE_H_
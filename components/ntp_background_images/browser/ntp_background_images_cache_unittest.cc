@@ -0,0 +1,77 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ntp_background_images/browser/ntp_background_images_cache.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ntp_background_images {
+
+class NTPBackgroundImagesCacheTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    image_path_ = temp_dir_.GetPath().AppendASCII("background-1.jpg");
+    ASSERT_TRUE(base::WriteFile(image_path_, "image data"));
+  }
+
+  scoped_refptr<base::RefCountedMemory> GetImage(
+      const base::FilePath& path) {
+    scoped_refptr<base::RefCountedMemory> result;
+    cache_.GetImage(path, base::BindOnce(
+                              [](scoped_refptr<base::RefCountedMemory>* result,
+                                 scoped_refptr<base::RefCountedMemory> image) {
+                                *result = std::move(image);
+                              },
+                              &result));
+    task_environment_.RunUntilIdle();
+    return result;
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath image_path_;
+  NTPBackgroundImagesCache cache_;
+};
+
+TEST_F(NTPBackgroundImagesCacheTest, ServesCachedImageWithoutCopy) {
+  auto first = GetImage(image_path_);
+  ASSERT_TRUE(first);
+  EXPECT_EQ("image data", std::string(first->front_as<char>(), first->size()));
+
+  // The file is gone, but the cached bytes are still served.
+  ASSERT_TRUE(base::DeleteFile(image_path_));
+  auto second = GetImage(image_path_);
+  EXPECT_EQ(first.get(), second.get());
+}
+
+TEST_F(NTPBackgroundImagesCacheTest, PrefetchAndMissingFiles) {
+  cache_.Prefetch(image_path_);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(10u, cache_.size_for_testing());
+
+  EXPECT_FALSE(GetImage(temp_dir_.GetPath().AppendASCII("missing.jpg")));
+  EXPECT_EQ(10u, cache_.size_for_testing());
+}
+
+TEST_F(NTPBackgroundImagesCacheTest, DropsImagesOnMemoryPressure) {
+  ASSERT_TRUE(GetImage(image_path_));
+  EXPECT_EQ(10u, cache_.size_for_testing());
+
+  base::MemoryPressureListener::SimulatePressureNotification(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(0u, cache_.size_for_testing());
+}
+
+}  // namespace ntp_background_images
@@ -443,6 +443,9 @@ void NTPBackgroundImagesService::OnComponentReady(
 void NTPBackgroundImagesService::OnGetComponentJsonData(
     bool is_super_referral,
     const std::string& json_string) {
+  // Cached images may belong to the previous version of the component.
+  image_cache_.Clear();
+
   if (is_super_referral) {
     local_pref_->SetBoolean(
           prefs::kNewTabPageGetInitialSRComponentInProgress,
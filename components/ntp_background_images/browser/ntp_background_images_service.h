@@ -16,6 +16,7 @@
 #include "base/observer_list.h"
 #include "base/timer/timer.h"
 #include "base/values.h"
+#include "brave/components/ntp_background_images/browser/ntp_background_images_cache.h"
 #include "components/prefs/pref_change_registrar.h"
 
 namespace component_updater {
@@ -68,6 +69,9 @@ class NTPBackgroundImagesService {
 
   std::vector<std::string> GetTopSitesFaviconList() const;
 
+  // Shared by all profiles' image sources.
+  NTPBackgroundImagesCache* image_cache() { return &image_cache_; }
+
  private:
   friend class TestNTPBackgroundImagesService;
   friend class NTPBackgroundImagesServiceTest;
@@ -141,6 +145,7 @@ class NTPBackgroundImagesService {
   base::ObserverList<Observer>::Unchecked observer_list_;
   std::unique_ptr<NTPBackgroundImagesData> si_images_data_;
   std::unique_ptr<NTPBackgroundImagesData> sr_images_data_;
+  NTPBackgroundImagesCache image_cache_;
   PrefChangeRegistrar pref_change_registrar_;
   // This is only used for registration during initial(first) SR component
   // download. After initial download is done, it's cached to
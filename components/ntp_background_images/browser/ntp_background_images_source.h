@@ -8,8 +8,6 @@
 
 #include <string>
 
-#include "base/memory/weak_ptr.h"
-#include "base/optional.h"
 #include "content/public/browser/url_data_source.h"
 
 namespace base {
@@ -46,8 +44,6 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
 
   void GetImageFile(const base::FilePath& image_file_path,
                     GotDataCallback callback);
-  void OnGotImageFile(GotDataCallback callback,
-                      base::Optional<std::string> input);
   bool IsValidPath(const std::string& path) const;
   bool IsLogoPath(const std::string& path) const;
   bool IsDefaultLogoPath(const std::string& path) const;
@@ -58,7 +54,6 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   base::FilePath GetTopSiteFaviconFilePath(const std::string& path) const;
 
   NTPBackgroundImagesService* service_;  // not owned
-  base::WeakPtrFactory<NTPBackgroundImagesSource> weak_factory_;
 };
 
 }  // namespace ntp_background_images
@@ -23,6 +23,16 @@ bool ViewCounterModel::ShouldShowBrandedWallpaper() const {
   return count_to_branded_wallpaper_ == 0;
 }
 
+int ViewCounterModel::GetNextWallpaperImageIndex() const {
+  if (total_image_count_ <= 0)
+    return current_wallpaper_image_index_;
+
+  // See RegisterPageView() for when the index moves on.
+  if (ignore_count_to_branded_wallpaper_ || count_to_branded_wallpaper_ == 0)
+    return (current_wallpaper_image_index_ + 1) % total_image_count_;
+  return current_wallpaper_image_index_;
+}
+
 void ViewCounterModel::ResetCurrentWallpaperImageIndex() {
   current_wallpaper_image_index_ = 0;
 }
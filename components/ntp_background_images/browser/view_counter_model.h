@@ -28,6 +28,8 @@ class ViewCounterModel {
   }
 
   bool ShouldShowBrandedWallpaper() const;
+  // Index of the wallpaper the next branded view will show.
+  int GetNextWallpaperImageIndex() const;
   void RegisterPageView();
   void ResetCurrentWallpaperImageIndex();
 
@@ -80,4 +80,21 @@ TEST(ViewCounterModelTest, NTPSuperReferralTest) {
   }
 }
 
+TEST(ViewCounterModelTest, NextWallpaperImageIndexTest) {
+  for (bool super_referral : {false, true}) {
+    ViewCounterModel model;
+    model.set_ignore_count_to_branded_wallpaper(super_referral);
+    model.set_total_image_count(kTestImageCount);
+
+    // Every branded view should show the image predicted at the view before.
+    int expected_index = model.GetNextWallpaperImageIndex();
+    for (int i = 0; i < 20; ++i) {
+      model.RegisterPageView();
+      if (model.ShouldShowBrandedWallpaper())
+        EXPECT_EQ(expected_index, model.current_wallpaper_image_index());
+      expected_index = model.GetNextWallpaperImageIndex();
+    }
+  }
+}
+
 }  // namespace ntp_background_images
@@ -14,11 +14,13 @@
 #include "base/files/file_path.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/time/time.h"
 #include "bat/ads/pref_names.h"
 #include "bat/ads/public/interfaces/ads.mojom.h"
 #include "brave/components/brave_referrals/buildflags/buildflags.h"
 #include "brave/components/brave_rewards/common/pref_names.h"
 #include "brave/components/ntp_background_images/browser/features.h"
+#include "brave/components/ntp_background_images/browser/ntp_background_images_cache.h"
 #include "brave/components/ntp_background_images/browser/ntp_background_images_data.h"
 #include "brave/components/ntp_background_images/browser/url_constants.h"
 #include "brave/components/ntp_background_images/common/pref_names.h"
@@ -33,6 +35,11 @@ constexpr char kNewTabsCreated[] = "brave.new_tab_page.p3a_new_tabs_created";
 constexpr char kSponsoredNewTabsCreated[] =
     "brave.new_tab_page.p3a_sponsored_new_tabs_created";
 
+// New tab counts are bumped on every new tab, so batch their local state
+// writes. Losing a few seconds of counts on a crash is fine for P3A.
+constexpr base::TimeDelta kNewTabsCreatedFlushDelay =
+    base::TimeDelta::FromSeconds(30);
+
 }  // namespace
 
 namespace ntp_background_images {
@@ -69,10 +76,10 @@ ViewCounterService::ViewCounterService(NTPBackgroundImagesService* service,
   DCHECK(service_);
   service_->AddObserver(this);
 
-  new_tab_count_state_ =
-      std::make_unique<WeeklyStorage>(local_state, kNewTabsCreated);
-  branded_new_tab_count_state_ =
-      std::make_unique<WeeklyStorage>(local_state, kSponsoredNewTabsCreated);
+  new_tab_count_state_ = std::make_unique<WeeklyStorage>(
+      local_state, kNewTabsCreated, kNewTabsCreatedFlushDelay);
+  branded_new_tab_count_state_ = std::make_unique<WeeklyStorage>(
+      local_state, kSponsoredNewTabsCreated, kNewTabsCreatedFlushDelay);
 
   if (auto* data = GetCurrentBrandedWallpaperData())
     model_.set_total_image_count(data->backgrounds.size());
@@ -153,6 +160,8 @@ std::vector<TopSite> ViewCounterService::GetTopSitesVectorData() const {
 }
 
 void ViewCounterService::Shutdown() {
+  new_tab_count_state_->Flush();
+  branded_new_tab_count_state_->Flush();
   service_->RemoveObserver(this);
 }
 
@@ -217,9 +226,27 @@ void ViewCounterService::RegisterPageView() {
   // or the user opt-in status changing.
   if (IsBrandedWallpaperActive()) {
     model_.RegisterPageView();
+    // Most likely the image is requested right after this, so start reading
+    // it, along with the one the next branded view will use.
+    if (model_.ShouldShowBrandedWallpaper())
+      PrefetchWallpaper(model_.current_wallpaper_image_index());
+    PrefetchWallpaper(model_.GetNextWallpaperImageIndex());
   }
 }
 
+void ViewCounterService::PrefetchWallpaper(int index) {
+  auto* data = GetCurrentBrandedWallpaperData();
+  if (!data || index < 0 ||
+      static_cast<size_t>(index) >= data->backgrounds.size())
+    return;
+
+  NTPBackgroundImagesCache* cache = service_->image_cache();
+  const Background& background = data->backgrounds[index];
+  cache->Prefetch(background.image_file);
+  cache->Prefetch(background.logo ? background.logo->image_file
+                                  : data->default_logo.image_file);
+}
+
 void ViewCounterService::BrandedWallpaperLogoClicked(
     const std::string& creative_instance_id,
     const std::string& destination_url,
@@ -120,6 +120,9 @@ class ViewCounterService : public KeyedService,
 
   void ResetModel();
 
+  // Warms up the image cache for the wallpaper at |index| and its logo.
+  void PrefetchWallpaper(int index);
+
   void UpdateP3AValues() const;
 
   NTPBackgroundImagesService* service_ = nullptr;  // not owned
@@ -0,0 +1,59 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/omnibox/browser/site_substring_index.h"
+
+#include <algorithm>
+#include <utility>
+
+SiteSubstringIndex::SiteSubstringIndex(std::vector<std::string> entries)
+    : entries_(std::move(entries)) {
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const std::string& entry = entries_[i];
+    for (size_t length = 1; length <= kMaxGramLength; ++length) {
+      for (size_t pos = 0; pos + length <= entry.length(); ++pos) {
+        std::vector<size_t>& posting = postings_[entry.substr(pos, length)];
+        // Entries are visited in order, so each list stays sorted.
+        if (posting.empty() || posting.back() != i)
+          posting.push_back(i);
+      }
+    }
+  }
+}
+
+SiteSubstringIndex::~SiteSubstringIndex() = default;
+
+std::vector<SiteSubstringIndex::Match> SiteSubstringIndex::FindMatches(
+    base::StringPiece query,
+    size_t max_matches) const {
+  std::vector<Match> matches;
+  if (query.empty() || max_matches == 0)
+    return matches;
+
+  // Pick the n-gram of the query with the fewest candidates.
+  const size_t gram_length = std::min(query.length(), kMaxGramLength);
+  const std::vector<size_t>* candidates = nullptr;
+  for (size_t pos = 0; pos + gram_length <= query.length(); ++pos) {
+    // Short enough for the small string optimization, so this doesn't
+    // allocate.
+    auto it = postings_.find(query.substr(pos, gram_length).as_string());
+    if (it == postings_.end())
+      return matches;
+    if (!candidates || it->second.size() < candidates->size())
+      candidates = &it->second;
+  }
+
+  for (size_t index : *candidates) {
+    // Always found when the query is a single n-gram.
+    const size_t position =
+        entries_[index].find(query.data(), 0, query.length());
+    if (position == std::string::npos)
+      continue;
+    matches.push_back({index, position});
+    if (matches.size() >= max_matches)
+      break;
+  }
+  return matches;
+}
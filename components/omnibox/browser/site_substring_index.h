@@ -0,0 +1,47 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_OMNIBOX_BROWSER_SITE_SUBSTRING_INDEX_H_
+#define BRAVE_COMPONENTS_OMNIBOX_BROWSER_SITE_SUBSTRING_INDEX_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+
+// N-gram inverted index over a fixed list of lowercase ASCII strings, used by
+// the omnibox providers to find substring matches without scanning the whole
+// list on every keystroke. Every 1, 2 and 3 character substring of an entry
+// maps to the sorted indexes of the entries containing it. A query looks up
+// its rarest n-gram and only verifies the entries on that list.
+class SiteSubstringIndex {
+ public:
+  struct Match {
+    // Index into the list the index was built from.
+    size_t index;
+    // Position of the first occurrence of the query in the entry.
+    size_t position;
+  };
+
+  explicit SiteSubstringIndex(std::vector<std::string> entries);
+  ~SiteSubstringIndex();
+
+  SiteSubstringIndex(const SiteSubstringIndex&) = delete;
+  SiteSubstringIndex& operator=(const SiteSubstringIndex&) = delete;
+
+  // Returns up to |max_matches| entries containing |query|, in the order of
+  // the original list, which is how providers rank them.
+  std::vector<Match> FindMatches(base::StringPiece query,
+                                 size_t max_matches) const;
+
+ private:
+  static constexpr size_t kMaxGramLength = 3;
+
+  const std::vector<std::string> entries_;
+  std::map<std::string, std::vector<size_t>> postings_;
+};
+
+#endif  // BRAVE_COMPONENTS_OMNIBOX_BROWSER_SITE_SUBSTRING_INDEX_H_
@@ -0,0 +1,65 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/omnibox/browser/site_substring_index.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const std::vector<std::string>& GetSites() {
+  static const std::vector<std::string> sites = {
+      "google.com",   "gmail.com",     "mail.google.com", "maps.google.com",
+      "facebook.com", "youtube.com",   "yahoo.com",       "wikipedia.org",
+      "twitter.com",  "linkedin.com",  "amazon.com",      "amazon.ca",
+      "dex.ru",       "index.hu",      "brave.com",       "a.co"};
+  return sites;
+}
+
+// What the providers used to do: scan every entry.
+std::vector<std::pair<size_t, size_t>> FindByScanning(const std::string& query,
+                                                      size_t max_matches) {
+  std::vector<std::pair<size_t, size_t>> matches;
+  const auto& sites = GetSites();
+  for (size_t i = 0; i < sites.size() && matches.size() < max_matches; ++i) {
+    const size_t position = sites[i].find(query);
+    if (position != std::string::npos)
+      matches.emplace_back(i, position);
+  }
+  return matches;
+}
+
+}  // namespace
+
+TEST(SiteSubstringIndexTest, MatchesScanForTypedPrefixes) {
+  SiteSubstringIndex index(GetSites());
+
+  // Replay typing of a few inputs keystroke by keystroke.
+  for (const std::string typed :
+       {"google.com", "mail", "amazon.c", "dex", "ogle.co", "zzz", "a.co",
+        "com", ".", "o"}) {
+    for (size_t length = 1; length <= typed.length(); ++length) {
+      const std::string query = typed.substr(0, length);
+      for (size_t max_matches : {1u, 3u, 100u}) {
+        std::vector<std::pair<size_t, size_t>> found;
+        for (const auto& match : index.FindMatches(query, max_matches))
+          found.emplace_back(match.index, match.position);
+        EXPECT_EQ(FindByScanning(query, max_matches), found)
+            << "query: " << query << " max: " << max_matches;
+      }
+    }
+  }
+}
+
+TEST(SiteSubstringIndexTest, EmptyAndNonAsciiQueries) {
+  SiteSubstringIndex index(GetSites());
+  EXPECT_TRUE(index.FindMatches("", 10).empty());
+  EXPECT_TRUE(index.FindMatches("google", 0).empty());
+  EXPECT_TRUE(index.FindMatches("тест", 10).empty());
+}
@@ -16,6 +16,7 @@
 #include "components/omnibox/browser/autocomplete_provider.h"
 
 class AutocompleteProviderClient;
+class SiteSubstringIndex;
 
 // This is the provider for Brave Suggested Sites
 class SuggestedSitesProvider : public AutocompleteProvider {
@@ -30,7 +31,9 @@ class SuggestedSitesProvider : public AutocompleteProvider {
 
   static const int kRelevance;
 
-  const std::vector<SuggestedSitesMatch>& GetSuggestedSites();
+  static const std::vector<SuggestedSitesMatch>& GetSuggestedSites();
+  // Index over the match strings of GetSuggestedSites(), built on first use.
+  static const SiteSubstringIndex& GetSuggestedSitesIndex();
   void AddMatch(const SuggestedSitesMatch& match,
                 const ACMatchClassifications& styles);
 
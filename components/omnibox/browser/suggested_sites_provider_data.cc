@@ -30,6 +30,7 @@ std::string GetLocalizedURL(const std::string& query_params, bool str_display) {
 
 }  // namespace
 
+// static
 const std::vector<SuggestedSitesMatch>&
 SuggestedSitesProvider::GetSuggestedSites() {
   static const std::vector<SuggestedSitesMatch> suggested_sites = {
@@ -51,29 +51,27 @@ void BraveP3ALogStore::RegisterPrefs(PrefRegistrySimple* registry) {
 
 void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
                                    uint64_t value) {
+  auto iter = log_.find(histogram_name);
+  if (iter != log_.end() && iter->second.value == value) {
+    return;
+  }
+
   LogEntry& entry = log_[histogram_name];
   entry.value = value;
   if (!entry.sent) {
     DCHECK(entry.sent_timestamp.is_null());
     unsent_entries_.insert(histogram_name);
   }
-
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({histogram_name, kLogValueKey},
-                  base::Value(base::NumberToString(value)));
-  update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+  dirty_entries_.insert(histogram_name);
 }
 
 void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
   DCHECK(delegate_->IsActualMetric(histogram_name));
-  log_.erase(histogram_name);
+  if (log_.erase(histogram_name)) {
+    dirty_entries_.insert(histogram_name);
+  }
   unsent_entries_.erase(histogram_name);
 
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->RemovePath(histogram_name);
-
   if (has_staged_log() && staged_entry_key_ == histogram_name) {
     staged_entry_key_.clear();
     staged_log_.clear();
@@ -82,18 +80,13 @@ void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
 
 void BraveP3ALogStore::ResetUploadStamps() {
   // Clear log entries flags.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
   for (auto& pair : log_) {
     if (pair.second.sent) {
       DCHECK(!pair.second.sent_timestamp.is_null());
       DCHECK(!unsent_entries_.contains(pair.first));
 
       pair.second.ResetSentState();
-
-      // Update persistent values.
-      update->SetPath({pair.first, kLogSentKey}, base::Value(pair.second.sent));
-      update->SetPath({pair.first, kLogTimestampKey},
-                      base::Value(pair.second.sent_timestamp.ToDoubleT()));
+      dirty_entries_.insert(pair.first);
     }
   }
 
@@ -106,6 +99,28 @@ void BraveP3ALogStore::ResetUploadStamps() {
   }
 }
 
+void BraveP3ALogStore::PersistDirtyEntries() {
+  if (dirty_entries_.empty()) {
+    return;
+  }
+
+  DictionaryPrefUpdate update(local_state_, kPrefName);
+  for (const std::string& histogram_name : dirty_entries_) {
+    auto iter = log_.find(histogram_name);
+    if (iter == log_.end()) {
+      update->RemovePath(histogram_name);
+      continue;
+    }
+    const LogEntry& entry = iter->second;
+    update->SetPath({histogram_name, kLogValueKey},
+                    base::Value(base::NumberToString(entry.value)));
+    update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+    update->SetPath({histogram_name, kLogTimestampKey},
+                    base::Value(entry.sent_timestamp.ToDoubleT()));
+  }
+  dirty_entries_.clear();
+}
+
 bool BraveP3ALogStore::has_unsent_logs() const {
   return !unsent_entries_.empty();
 }
@@ -167,12 +182,11 @@ void BraveP3ALogStore::DiscardStagedLog() {
   DCHECK(log_iter != log_.end());
   log_iter->second.MarkAsSent();
 
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({log_iter->first, kLogSentKey},
-                  base::Value(log_iter->second.sent));
-  update->SetPath({log_iter->first, kLogTimestampKey},
-                  base::Value(log_iter->second.sent_timestamp.ToDoubleT()));
+  // Persist the sent stamp right away, so the value isn't reported again if
+  // we don't shut down cleanly. This happens at most once per metric per
+  // rotation, so pending value changes are written along with it.
+  dirty_entries_.insert(log_iter->first);
+  PersistDirtyEntries();
 
   // Erase the entry from the unsent queue.
   auto unsent_entries_iter = unsent_entries_.find(staged_entry_key_);
@@ -19,7 +19,10 @@ class PrefRegistrySimple;
 
 namespace brave {
 
-// Stores all given values in memory and persists in prefs on the fly.
+// Stores all given values in memory. Changed entries are kept dirty and
+// written to prefs in a single update by |PersistDirtyEntries()|, which the
+// owner calls on rotation and on shutdown; sent stamps are persisted right
+// away to avoid reporting the same value twice after a crash.
 // All logs (not only unsent are persistent), and all logs could be loaded
 // using |LoadPersistedUnsentLogs()|. We should fix this at some point since
 // for now persisted entries never expire.
@@ -48,6 +51,8 @@ class BraveP3ALogStore : public metrics::LogStore {
   void RemoveValueIfExists(const std::string& histogram_name);
   // Marks all saved values as unsent.
   void ResetUploadStamps();
+  // Writes all entries changed since the last call to prefs in one update.
+  void PersistDirtyEntries();
 
   // metrics::LogStore:
   bool has_unsent_logs() const override;
@@ -60,8 +65,8 @@ class BraveP3ALogStore : public metrics::LogStore {
   void DiscardStagedLog() override;
   void MarkStagedLogAsSent() override;
 
-  // |TrimAndPersistUnsentLogs| should not be used, since we persist everything
-  // on the fly.
+  // |TrimAndPersistUnsentLogs| should not be used, use |PersistDirtyEntries|
+  // instead.
   void TrimAndPersistUnsentLogs() override;
   // Returns early if founds malformed persisted values.
   void LoadPersistedUnsentLogs() override;
@@ -90,6 +95,8 @@ class BraveP3ALogStore : public metrics::LogStore {
   // TODO(iefremov): Try to replace with base::StringPiece?
   base::flat_map<std::string, LogEntry> log_;
   base::flat_set<std::string> unsent_entries_;
+  // Entries changed or removed since the last |PersistDirtyEntries()|.
+  base::flat_set<std::string> dirty_entries_;
 
   std::string staged_entry_key_;
   std::string staged_log_;
@@ -0,0 +1,126 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_log_store.h"
+
+#include <memory>
+#include <string>
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/pref_registry_simple.h"
+#include "components/prefs/testing_pref_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveP3ALogStoreTest.*
+
+namespace brave {
+
+namespace {
+
+constexpr char kLogsPrefName[] = "p3a.logs";
+constexpr size_t kHistogramCount = 100;
+
+class TestDelegate : public BraveP3ALogStore::Delegate {
+ public:
+  std::string Serialize(base::StringPiece histogram_name,
+                        uint64_t value) override {
+    return histogram_name.as_string() + base::NumberToString(value);
+  }
+  bool IsActualMetric(base::StringPiece histogram_name) const override {
+    return true;
+  }
+};
+
+std::string HistogramName(size_t index) {
+  return "Brave.Test." + base::NumberToString(index);
+}
+
+}  // namespace
+
+class BraveP3ALogStoreTest : public ::testing::Test {
+ public:
+  BraveP3ALogStoreTest() {
+    BraveP3ALogStore::RegisterPrefs(pref_service_.registry());
+    log_store_ =
+        std::make_unique<BraveP3ALogStore>(&delegate_, &pref_service_);
+    log_store_->LoadPersistedUnsentLogs();
+
+    pref_change_registrar_.Init(&pref_service_);
+    pref_change_registrar_.Add(
+        kLogsPrefName, base::BindRepeating(&BraveP3ALogStoreTest::OnPrefWrite,
+                                           base::Unretained(this)));
+  }
+
+ protected:
+  void OnPrefWrite() { pref_writes_++; }
+
+  TestingPrefServiceSimple pref_service_;
+  TestDelegate delegate_;
+  std::unique_ptr<BraveP3ALogStore> log_store_;
+  PrefChangeRegistrar pref_change_registrar_;
+  size_t pref_writes_ = 0;
+};
+
+TEST_F(BraveP3ALogStoreTest, CoalescesPrefWritesPerBrowsingHour) {
+  // Roughly an hour of browsing: a page load every 10 seconds, each one
+  // touching every collected histogram.
+  for (size_t page_load = 0; page_load < 360; page_load++) {
+    for (size_t i = 0; i < kHistogramCount; i++) {
+      log_store_->UpdateValue(HistogramName(i), page_load % 4);
+    }
+  }
+  EXPECT_EQ(pref_writes_, 0u);
+
+  log_store_->PersistDirtyEntries();
+  EXPECT_EQ(pref_writes_, 1u);
+
+  // Nothing changed since the last flush.
+  log_store_->PersistDirtyEntries();
+  EXPECT_EQ(pref_writes_, 1u);
+
+  const base::Value* logs = pref_service_.GetDictionary(kLogsPrefName);
+  EXPECT_EQ(logs->DictSize(), kHistogramCount);
+}
+
+TEST_F(BraveP3ALogStoreTest, UnchangedValuesAreNotDirty) {
+  log_store_->UpdateValue(HistogramName(0), 1);
+  log_store_->PersistDirtyEntries();
+  EXPECT_EQ(pref_writes_, 1u);
+
+  log_store_->UpdateValue(HistogramName(0), 1);
+  log_store_->PersistDirtyEntries();
+  EXPECT_EQ(pref_writes_, 1u);
+}
+
+TEST_F(BraveP3ALogStoreTest, PersistsRemovalsAndSentStamps) {
+  log_store_->UpdateValue(HistogramName(0), 1);
+  log_store_->UpdateValue(HistogramName(1), 2);
+  log_store_->PersistDirtyEntries();
+  EXPECT_EQ(pref_writes_, 1u);
+
+  log_store_->RemoveValueIfExists(HistogramName(1));
+  EXPECT_EQ(pref_writes_, 1u);
+
+  // Sent stamps are written immediately, along with pending changes.
+  log_store_->StageNextLog();
+  log_store_->DiscardStagedLog();
+  EXPECT_EQ(pref_writes_, 2u);
+  EXPECT_FALSE(log_store_->has_unsent_logs());
+
+  const base::Value* logs = pref_service_.GetDictionary(kLogsPrefName);
+  EXPECT_EQ(logs->DictSize(), 1u);
+  const base::Value* entry = logs->FindDictKey(HistogramName(0));
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(entry->FindBoolKey("sent"), true);
+
+  // A reloaded store picks up the persisted state.
+  BraveP3ALogStore reloaded(&delegate_, &pref_service_);
+  reloaded.LoadPersistedUnsentLogs();
+  EXPECT_FALSE(reloaded.has_unsent_logs());
+}
+
+}  // namespace brave
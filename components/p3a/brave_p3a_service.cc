@@ -284,6 +284,12 @@ void BraveP3AService::Init(
   }
 }
 
+void BraveP3AService::Shutdown() {
+  if (log_store_) {
+    log_store_->PersistDirtyEntries();
+  }
+}
+
 std::string BraveP3AService::Serialize(base::StringPiece histogram_name,
                                        uint64_t value) {
   // TRACE_EVENT0("brave_p3a", "SerializeMessage");
@@ -414,6 +420,9 @@ void BraveP3AService::OnHistogramChanged(const char* histogram_name,
   // Shortcut for the special values, see |kSuspendedMetricValue|
   // description for details.
   if (IsSuspendedMetric(histogram_name, sample)) {
+    if (!UpdateLastBucket(histogram_name, kSuspendedMetricBucket)) {
+      return;
+    }
     base::PostTask(FROM_HERE, {content::BrowserThread::UI},
                    base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI,
                                   this,
@@ -432,6 +441,12 @@ void BraveP3AService::OnHistogramChanged(const char* histogram_name,
     return;
   }
 
+  // The log only keeps the latest bucket, so there is nothing to do if it
+  // hasn't changed.
+  if (!UpdateLastBucket(histogram_name, bucket)) {
+    return;
+  }
+
   // Special handling of P2A histograms.
   if (base::StartsWith(histogram_name, "Brave.P2A.",
                        base::CompareCase::SENSITIVE)) {
@@ -453,6 +468,17 @@ void BraveP3AService::OnHistogramChanged(const char* histogram_name,
                                 histogram_name, sample, bucket));
 }
 
+bool BraveP3AService::UpdateLastBucket(base::StringPiece histogram_name,
+                                       size_t bucket) {
+  base::AutoLock lock(last_buckets_lock_);
+  auto iter = last_buckets_.find(histogram_name);
+  if (iter != last_buckets_.end() && iter->second == bucket) {
+    return false;
+  }
+  last_buckets_[histogram_name] = bucket;
+  return true;
+}
+
 void BraveP3AService::OnHistogramChangedOnUI(const char* histogram_name,
                                              base::HistogramBase::Sample sample,
                                              size_t bucket) {
@@ -495,6 +521,7 @@ void BraveP3AService::OnLogUploadComplete(int response_code,
 void BraveP3AService::DoRotation() {
   VLOG(2) << "BraveP3AService doing rotation at " << base::Time::Now();
   log_store_->ResetUploadStamps();
+  log_store_->PersistDirtyEntries();
   UpdateRotationTimer();
 
   local_state_->SetTime(kLastRotationTimeStampPref, base::Time::Now());
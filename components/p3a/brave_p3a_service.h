@@ -12,6 +12,7 @@
 #include "base/containers/flat_map.h"
 #include "base/memory/ref_counted.h"
 #include "base/metrics/histogram_base.h"
+#include "base/synchronization/lock.h"
 #include "base/timer/timer.h"
 #include "brave/components/brave_prochlo/brave_prochlo_message.h"
 #include "brave/components/p3a/brave_p3a_log_store.h"
@@ -49,6 +50,10 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   void Init(
       scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory);
 
+  // Writes pending log changes to local state. Should be called before the
+  // local state goes away.
+  void Shutdown();
+
   // BraveP3ALogStore::Delegate
   std::string Serialize(base::StringPiece histogram_name,
                         uint64_t value) override;
@@ -75,6 +80,10 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
                           uint64_t name_hash,
                           base::HistogramBase::Sample sample);
 
+  // Remembers |bucket| for the histogram and returns false if it is the same
+  // as the last one, so the sample can be dropped. Thread-safe.
+  bool UpdateLastBucket(base::StringPiece histogram_name, size_t bucket);
+
   void OnHistogramChangedOnUI(const char* histogram_name,
                               base::HistogramBase::Sample sample,
                               size_t bucket);
@@ -114,6 +123,11 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   // the service and its initialization.
   base::flat_map<base::StringPiece, size_t> histogram_values_;
 
+  // Last bucket seen for each histogram, used to drop unchanged samples
+  // before hopping to the UI thread. Accessed from any thread.
+  base::Lock last_buckets_lock_;
+  base::flat_map<base::StringPiece, size_t> last_buckets_;
+
   // Once fired we restart the overall uploading process.
   base::OneShotTimer rotation_timer_;
 
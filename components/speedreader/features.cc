@@ -22,4 +22,7 @@ const base::Feature kSpeedreaderFeature {
 const base::Feature kSpeedreaderLegacyBackend{
     "Speedreader Legacy Backend", base::FEATURE_DISABLED_BY_DEFAULT};
 
+const base::Feature kSpeedreaderStreamingRewrite{
+    "SpeedreaderStreamingRewrite", base::FEATURE_DISABLED_BY_DEFAULT};
+
 }  // namespace speedreader
@@ -33,6 +33,9 @@ namespace speedreader {
 
 using RewriterType = C_CRewriterType;
 
+// Rewriter output shorter than this is not considered a distilled page.
+constexpr size_t kMinDistilledLength = 1024;
+
 class SPEEDREADER_EXPORT Rewriter {
  public:
   /// Create a buffering `Rewriter`. Output will be accumulated internally,
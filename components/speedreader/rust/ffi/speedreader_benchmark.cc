@@ -0,0 +1,289 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Replays a corpus of saved pages through the speedreader FFI wrapper and
+// reports throughput, time to first output and time spent in End() (where the
+// heuristics rewriter classifies and extracts the page) per page, and the peak
+// memory of the whole run.
+//
+// Only the raw Rewriter is measured: the stylesheet, thread hops and data
+// pipes of SpeedreaderRewriterService and SpeedReaderURLLoader are not part
+// of the figures.
+//
+// Usage:
+//   speedreader_ffi_benchmark --corpus=<dir> [--config=<whitelist.dat>]
+//       [--rewriter=heuristics|streaming|auto] [--iterations=N]
+//       [--chunk-size=BYTES]
+//
+// Every <name>.html file in the corpus is a page. Its URL is read from an
+// optional <name>.url file next to it, https://example.com/<name> otherwise.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/time/time.h"
+#include "brave/components/speedreader/rust/ffi/speedreader.h"
+#include "build/build_config.h"
+
+#if defined(OS_POSIX)
+#include <sys/resource.h>
+#elif defined(OS_WIN)
+#include "base/process/process_metrics.h"
+#endif
+
+namespace {
+
+constexpr char kCorpusSwitch[] = "corpus";
+constexpr char kConfigSwitch[] = "config";
+constexpr char kRewriterSwitch[] = "rewriter";
+constexpr char kIterationsSwitch[] = "iterations";
+constexpr char kChunkSizeSwitch[] = "chunk-size";
+
+constexpr int kDefaultIterations = 5;
+// Roughly what a single read from the network data pipe hands us.
+constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+struct Page {
+  std::string name;
+  std::string url;
+  std::string body;
+};
+
+struct RunResult {
+  base::TimeDelta total;
+  base::TimeDelta first_output;
+  base::TimeDelta end;
+  size_t output_length = 0;
+  bool ok = false;
+};
+
+struct SinkState {
+  base::TimeTicks start;
+  base::TimeTicks first_output;
+  size_t output_length = 0;
+};
+
+void OnOutput(const char* chunk, size_t chunk_len, void* user_data) {
+  auto* state = static_cast<SinkState*>(user_data);
+  if (state->first_output.is_null())
+    state->first_output = base::TimeTicks::Now();
+  state->output_length += chunk_len;
+}
+
+// Returns the process high watermark in bytes, or 0 if unknown.
+uint64_t GetPeakMemoryBytes() {
+#if defined(OS_POSIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(OS_MAC)
+  return usage.ru_maxrss;
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#elif defined(OS_WIN)
+  return base::ProcessMetrics::CreateCurrentProcessMetrics()
+      ->GetPeakWorkingSetSize();
+#else
+  return 0;
+#endif
+}
+
+std::vector<Page> LoadCorpus(const base::FilePath& corpus_dir) {
+  std::vector<Page> pages;
+  base::FileEnumerator enumerator(corpus_dir, false,
+                                  base::FileEnumerator::FILES,
+                                  FILE_PATH_LITERAL("*.html"));
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    Page page;
+    page.name = path.BaseName().RemoveExtension().AsUTF8Unsafe();
+    if (!base::ReadFileToString(path, &page.body)) {
+      fprintf(stderr, "Failed to read %s\n", path.AsUTF8Unsafe().c_str());
+      continue;
+    }
+    std::string url;
+    if (base::ReadFileToString(path.ReplaceExtension(FILE_PATH_LITERAL("url")),
+                               &url)) {
+      base::TrimWhitespaceASCII(url, base::TRIM_ALL, &page.url);
+    }
+    if (page.url.empty())
+      page.url = "https://example.com/" + page.name;
+    pages.push_back(std::move(page));
+  }
+  std::sort(pages.begin(), pages.end(),
+            [](const Page& a, const Page& b) { return a.name < b.name; });
+  return pages;
+}
+
+RunResult RunPage(speedreader::SpeedReader* speedreader,
+                  const Page& page,
+                  speedreader::RewriterType rewriter_type,
+                  size_t chunk_size) {
+  RunResult result;
+  SinkState state;
+  state.start = base::TimeTicks::Now();
+
+  std::unique_ptr<speedreader::Rewriter> rewriter = speedreader->MakeRewriter(
+      page.url, rewriter_type, &OnOutput, &state);
+  bool ok = true;
+  for (size_t offset = 0; ok && offset < page.body.length();
+       offset += chunk_size) {
+    const size_t length = std::min(chunk_size, page.body.length() - offset);
+    ok = rewriter->Write(page.body.data() + offset, length) == 0;
+  }
+  const base::TimeTicks end_start = base::TimeTicks::Now();
+  if (ok)
+    ok = rewriter->End() == 0;
+  const base::TimeTicks done = base::TimeTicks::Now();
+
+  result.total = done - state.start;
+  result.end = done - end_start;
+  if (!state.first_output.is_null())
+    result.first_output = state.first_output - state.start;
+  result.output_length = state.output_length;
+  result.ok = ok;
+  return result;
+}
+
+const char* GetDistilledState(const RunResult& result) {
+  if (!result.ok)
+    return "error";
+  return result.output_length >= speedreader::kMinDistilledLength ? "yes"
+                                                                   : "no";
+}
+
+double MegabytesPerSecond(size_t bytes, base::TimeDelta time) {
+  if (time.is_zero())
+    return 0;
+  return bytes / (1024.0 * 1024.0) / time.InSecondsF();
+}
+
+bool ParseRewriterType(const std::string& name,
+                       speedreader::RewriterType* type) {
+  if (name.empty() || name == "heuristics") {
+    *type = speedreader::RewriterType::RewriterHeuristics;
+  } else if (name == "streaming") {
+    *type = speedreader::RewriterType::RewriterStreaming;
+  } else if (name == "auto") {
+    *type = speedreader::RewriterType::RewriterUnknown;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  base::AtExitManager at_exit;
+  base::CommandLine::Init(argc, argv);
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+
+  const base::FilePath corpus_dir =
+      command_line.GetSwitchValuePath(kCorpusSwitch);
+  if (corpus_dir.empty()) {
+    fprintf(stderr, "Usage: %s --corpus=<dir> [--config=<whitelist.dat>] "
+            "[--rewriter=heuristics|streaming|auto] [--iterations=N] "
+            "[--chunk-size=BYTES]\n"
+            "Measures the FFI Rewriter only, not SpeedreaderRewriterService "
+            "or the URLLoader path.\n", argv[0]);
+    return 1;
+  }
+
+  speedreader::RewriterType rewriter_type;
+  if (!ParseRewriterType(command_line.GetSwitchValueASCII(kRewriterSwitch),
+                         &rewriter_type)) {
+    fprintf(stderr, "Unknown rewriter type\n");
+    return 1;
+  }
+
+  int iterations = kDefaultIterations;
+  if (command_line.HasSwitch(kIterationsSwitch) &&
+      (!base::StringToInt(command_line.GetSwitchValueASCII(kIterationsSwitch),
+                          &iterations) ||
+       iterations <= 0)) {
+    fprintf(stderr, "Invalid --%s\n", kIterationsSwitch);
+    return 1;
+  }
+
+  size_t chunk_size = kDefaultChunkSize;
+  if (command_line.HasSwitch(kChunkSizeSwitch) &&
+      (!base::StringToSizeT(command_line.GetSwitchValueASCII(kChunkSizeSwitch),
+                            &chunk_size) ||
+       chunk_size == 0)) {
+    fprintf(stderr, "Invalid --%s\n", kChunkSizeSwitch);
+    return 1;
+  }
+
+  speedreader::SpeedReader speedreader;
+  const base::FilePath config_path =
+      command_line.GetSwitchValuePath(kConfigSwitch);
+  if (!config_path.empty()) {
+    std::string config;
+    if (!base::ReadFileToString(config_path, &config) ||
+        !speedreader.deserialize(config.data(), config.length())) {
+      fprintf(stderr, "Failed to load %s\n",
+              config_path.AsUTF8Unsafe().c_str());
+      return 1;
+    }
+  }
+
+  const std::vector<Page> pages = LoadCorpus(corpus_dir);
+  if (pages.empty()) {
+    fprintf(stderr, "No *.html pages in %s\n",
+            corpus_dir.AsUTF8Unsafe().c_str());
+    return 1;
+  }
+
+  const uint64_t baseline_memory = GetPeakMemoryBytes();
+  size_t total_bytes = 0;
+  base::TimeDelta total_time;
+
+  printf("page,bytes,distilled,mb_per_s,first_output_ms,end_ms\n");
+  for (const Page& page : pages) {
+    base::TimeDelta page_total;
+    base::TimeDelta page_first_output;
+    base::TimeDelta page_end;
+    RunResult result;
+    for (int i = 0; i < iterations; ++i) {
+      result = RunPage(&speedreader, page, rewriter_type, chunk_size);
+      page_total += result.total;
+      page_first_output += result.first_output;
+      page_end += result.end;
+    }
+    total_bytes += page.body.length() * iterations;
+    total_time += page_total;
+
+    printf("%s,%zu,%s,%.2f,%.3f,%.3f\n", page.name.c_str(),
+           page.body.length(),
+           GetDistilledState(result),
+           MegabytesPerSecond(page.body.length() * iterations, page_total),
+           (page_first_output / iterations).InMillisecondsF(),
+           (page_end / iterations).InMillisecondsF());
+  }
+
+  // The high watermark only ever grows, so it is only meaningful for the
+  // whole run.
+  printf("\ntotal: %zu pages, %.2f MB/s, peak memory %llu KB "
+         "(+%llu KB over startup)\n",
+         pages.size(), MegabytesPerSecond(total_bytes, total_time),
+         static_cast<unsigned long long>(GetPeakMemoryBytes() / 1024),
+         static_cast<unsigned long long>(
+             (GetPeakMemoryBytes() - baseline_memory) / 1024));
+  return 0;
+}
@@ -45,6 +45,13 @@ class SpeedreaderRewriterService : public SpeedreaderComponent::Observer {
   // The API
   bool IsWhitelisted(const GURL& url);
   std::unique_ptr<Rewriter> MakeRewriter(const GURL& url);
+  // Makes a rewriter that hands every chunk of output to |output_sink|
+  // instead of accumulating it.
+  std::unique_ptr<Rewriter> MakeRewriter(const GURL& url,
+                                         void (*output_sink)(const char*,
+                                                             size_t,
+                                                             void*),
+                                         void* output_sink_user_data);
   const std::string& GetContentStylesheet();
 
  private:
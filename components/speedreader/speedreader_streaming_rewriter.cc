@@ -0,0 +1,85 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_streaming_rewriter.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "brave/components/speedreader/rust/ffi/speedreader.h"
+#include "brave/components/speedreader/speedreader_rewriter_service.h"
+#include "url/gurl.h"
+
+namespace speedreader {
+
+SpeedreaderStreamingRewriter::SpeedreaderStreamingRewriter(
+    SpeedreaderRewriterService* rewriter_service,
+    const GURL& url,
+    scoped_refptr<base::SequencedTaskRunner> loader_task_runner,
+    OutputCallback output_callback,
+    DoneCallback done_callback)
+    : loader_task_runner_(std::move(loader_task_runner)),
+      output_callback_(std::move(output_callback)),
+      done_callback_(std::move(done_callback)) {
+  // The rewriter is configured on the loader sequence, where the service
+  // lives, but only ever driven on the rewriter sequence.
+  rewriter_ = rewriter_service->MakeRewriter(
+      url, &SpeedreaderStreamingRewriter::OnOutput, this);
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+SpeedreaderStreamingRewriter::SpeedreaderStreamingRewriter() {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+SpeedreaderStreamingRewriter::~SpeedreaderStreamingRewriter() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+// static
+void SpeedreaderStreamingRewriter::OnOutput(const char* chunk,
+                                            size_t chunk_len,
+                                            void* user_data) {
+  auto* self = static_cast<SpeedreaderStreamingRewriter*>(user_data);
+  self->pending_output_.append(chunk, chunk_len);
+}
+
+void SpeedreaderStreamingRewriter::Write(std::string chunk) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (done_)
+    return;
+
+  if (rewriter_->Write(chunk.data(), chunk.length()) != 0) {
+    Finish(false);
+    return;
+  }
+  FlushOutput();
+}
+
+void SpeedreaderStreamingRewriter::End() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (done_)
+    return;
+
+  const bool success = rewriter_->End() == 0;
+  FlushOutput();
+  Finish(success);
+}
+
+void SpeedreaderStreamingRewriter::FlushOutput() {
+  if (pending_output_.empty())
+    return;
+  loader_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(output_callback_, std::move(pending_output_)));
+  pending_output_.clear();
+}
+
+void SpeedreaderStreamingRewriter::Finish(bool success) {
+  done_ = true;
+  loader_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(std::move(done_callback_), success));
+}
+
+}  // namespace speedreader
@@ -0,0 +1,76 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_STREAMING_REWRITER_H_
+#define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_STREAMING_REWRITER_H_
+
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequence_checker.h"
+#include "base/sequenced_task_runner.h"
+
+class GURL;
+
+namespace speedreader {
+
+class Rewriter;
+class SpeedreaderRewriterService;
+
+// Drives a |Rewriter| chunk by chunk on a background sequence. The instance is
+// created on the loader sequence and must be destroyed on
+// |rewriter_task_runner|, which is where all the Rewriter work happens.
+// Rewritten output is batched per input chunk and posted back to the loader
+// sequence through |output_callback|.
+class SpeedreaderStreamingRewriter {
+ public:
+  // Called with every non-empty chunk of rewritten output.
+  using OutputCallback = base::RepeatingCallback<void(std::string)>;
+  // Called once, either when the rewriter fails or when End() completes.
+  using DoneCallback = base::OnceCallback<void(bool success)>;
+
+  SpeedreaderStreamingRewriter(
+      SpeedreaderRewriterService* rewriter_service,
+      const GURL& url,
+      scoped_refptr<base::SequencedTaskRunner> loader_task_runner,
+      OutputCallback output_callback,
+      DoneCallback done_callback);
+  virtual ~SpeedreaderStreamingRewriter();
+
+  SpeedreaderStreamingRewriter(const SpeedreaderStreamingRewriter&) = delete;
+  SpeedreaderStreamingRewriter& operator=(const SpeedreaderStreamingRewriter&) =
+      delete;
+
+  // Must be called on the rewriter sequence.
+  virtual void Write(std::string chunk);
+  virtual void End();
+
+ protected:
+  // For fakes that don't drive a Rewriter.
+  SpeedreaderStreamingRewriter();
+
+ private:
+  static void OnOutput(const char* chunk, size_t chunk_len, void* user_data);
+
+  void FlushOutput();
+  void Finish(bool success);
+
+  std::unique_ptr<Rewriter> rewriter_;
+  // Output accumulated by the rewriter while processing the current chunk.
+  std::string pending_output_;
+  bool done_ = false;
+
+  scoped_refptr<base::SequencedTaskRunner> loader_task_runner_;
+  OutputCallback output_callback_;
+  DoneCallback done_callback_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace speedreader
+
+#endif  // BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_STREAMING_REWRITER_H_
@@ -10,13 +10,18 @@
 #include <utility>
 
 #include "base/bind.h"
+#include "base/feature_list.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/no_destructor.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
+#include "brave/components/speedreader/features.h"
 #include "brave/components/speedreader/rust/ffi/speedreader.h"
 #include "brave/components/speedreader/speedreader_rewriter_service.h"
+#include "brave/components/speedreader/speedreader_streaming_rewriter.h"
 #include "brave/components/speedreader/speedreader_throttle.h"
 #include "mojo/public/cpp/bindings/self_owned_receiver.h"
+#include "net/base/net_errors.h"
 #include "services/network/public/mojom/url_response_head.mojom.h"
 
 namespace speedreader {
@@ -25,6 +30,17 @@ namespace {
 
 constexpr uint32_t kReadBufferSize = 32768;
 
+// In streaming mode, reading from the source is paused while this much
+// rewritten output is waiting for the destination pipe.
+constexpr size_t kMaxPendingStreamingOutput = 8 * kReadBufferSize;
+
+SpeedReaderURLLoader::StreamingRewriterFactory&
+GetStreamingRewriterFactoryForTesting() {
+  static base::NoDestructor<SpeedReaderURLLoader::StreamingRewriterFactory>
+      factory;
+  return *factory;
+}
+
 }  // namespace
 
 // static
@@ -73,6 +89,12 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
 
 SpeedReaderURLLoader::~SpeedReaderURLLoader() = default;
 
+// static
+void SpeedReaderURLLoader::SetStreamingRewriterFactoryForTesting(
+    StreamingRewriterFactory factory) {
+  GetStreamingRewriterFactoryForTesting() = std::move(factory);
+}
+
 void SpeedReaderURLLoader::Start(
     mojo::PendingRemote<network::mojom::URLLoader> source_url_loader_remote,
     mojo::PendingReceiver<network::mojom::URLLoaderClient>
@@ -128,6 +150,8 @@ void SpeedReaderURLLoader::OnStartLoadingResponseBody(
       MOJO_HANDLE_SIGNAL_READABLE | MOJO_HANDLE_SIGNAL_PEER_CLOSED,
       base::BindRepeating(&SpeedReaderURLLoader::OnBodyReadable,
                           base::Unretained(this)));
+  if (base::FeatureList::IsEnabled(kSpeedreaderStreamingRewrite))
+    StartStreamingRewriter();
   body_consumer_watcher_.ArmOrNotify();
 }
 
@@ -193,6 +217,10 @@ void SpeedReaderURLLoader::ResumeReadingBodyFromNet() {
 
 void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
   DCHECK_EQ(State::kLoading, state_);
+  if (streaming_) {
+    ReadBodyForStreamingRewriter();
+    return;
+  }
 
   size_t start_size = buffered_body_.size();
   uint32_t read_bytes = kReadBufferSize;
@@ -226,12 +254,14 @@ void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
 }
 
 void SpeedReaderURLLoader::OnBodyWritable(MojoResult r) {
-  DCHECK_EQ(State::kSending, state_);
+  DCHECK(state_ == State::kSending ||
+         (streaming_ && state_ == State::kLoading));
   if (bytes_remaining_in_buffer_ > 0) {
     SendReceivedBodyToClient();
-  } else {
+  } else if (state_ == State::kSending) {
     CompleteSending();
   }
+  // Otherwise the streaming rewriter has more output to come.
 }
 
 void SpeedReaderURLLoader::MaybeLaunchSpeedreader() {
@@ -264,7 +294,7 @@ void SpeedReaderURLLoader::MaybeLaunchSpeedreader() {
               // TODO(brave-browser/issues/10372): would be better to pass
               // explicit signal back from rewriter to indicate if content was
               // found
-              if (transformed.length() < 1024) {
+              if (transformed.length() < kMinDistilledLength) {
                 return data;
               }
 
@@ -280,25 +310,183 @@ void SpeedReaderURLLoader::MaybeLaunchSpeedreader() {
   CompleteLoading(std::move(buffered_body_));
 }
 
-void SpeedReaderURLLoader::CompleteLoading(std::string body) {
+void SpeedReaderURLLoader::StartStreamingRewriter() {
   DCHECK_EQ(State::kLoading, state_);
-  state_ = State::kSending;
+  auto output_callback =
+      base::BindRepeating(&SpeedReaderURLLoader::OnStreamingRewriterOutput,
+                          weak_factory_.GetWeakPtr());
+  auto done_callback =
+      base::BindOnce(&SpeedReaderURLLoader::OnStreamingRewriterDone,
+                     weak_factory_.GetWeakPtr());
+  std::unique_ptr<SpeedreaderStreamingRewriter> rewriter;
+  if (GetStreamingRewriterFactoryForTesting()) {
+    rewriter = GetStreamingRewriterFactoryForTesting().Run(
+        std::move(output_callback), std::move(done_callback));
+  } else if (rewriter_service_) {
+    rewriter = std::make_unique<SpeedreaderStreamingRewriter>(
+        rewriter_service_, response_url_, task_runner_,
+        std::move(output_callback), std::move(done_callback));
+  } else {
+    return;
+  }
 
-  if (!throttle_) {
+  streaming_ = true;
+  streaming_start_time_ = base::TimeTicks::Now();
+  rewriter_task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
+      {base::TaskPriority::USER_BLOCKING});
+  streaming_rewriter_ =
+      std::unique_ptr<SpeedreaderStreamingRewriter, base::OnTaskRunnerDeleter>(
+          rewriter.release(), base::OnTaskRunnerDeleter(rewriter_task_runner_));
+}
+
+void SpeedReaderURLLoader::ReadBodyForStreamingRewriter() {
+  DCHECK(streaming_);
+  std::string chunk(kReadBufferSize, '\0');
+  uint32_t read_bytes = kReadBufferSize;
+  MojoResult result = body_consumer_handle_->ReadData(
+      &chunk[0], &read_bytes, MOJO_READ_DATA_FLAG_NONE);
+  switch (result) {
+    case MOJO_RESULT_OK:
+      break;
+    case MOJO_RESULT_FAILED_PRECONDITION:
+      // Reading is finished.
+      streaming_input_ended_ = true;
+      rewriter_task_runner_->PostTask(
+          FROM_HERE, base::BindOnce(&SpeedreaderStreamingRewriter::End,
+                                    base::Unretained(
+                                        streaming_rewriter_.get())));
+      MaybeFinishStreaming();
+      return;
+    case MOJO_RESULT_SHOULD_WAIT:
+      body_consumer_watcher_.ArmOrNotify();
+      return;
+    default:
+      NOTREACHED();
+      return;
+  }
+
+  chunk.resize(read_bytes);
+  if (!streaming_committed_)
+    streaming_original_body_.append(chunk);
+  // |streaming_rewriter_| is deleted on |rewriter_task_runner_|, so it
+  // outlives any task posted before that.
+  rewriter_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&SpeedreaderStreamingRewriter::Write,
+                     base::Unretained(streaming_rewriter_.get()),
+                     std::move(chunk)));
+
+  if (bytes_remaining_in_buffer_ >= kMaxPendingStreamingOutput) {
+    // The destination doesn't keep up with the rewritten output, resumed from
+    // SendReceivedBodyToClient().
+    streaming_read_paused_ = true;
+    return;
+  }
+  body_consumer_watcher_.ArmOrNotify();
+}
+
+void SpeedReaderURLLoader::OnStreamingRewriterOutput(std::string output) {
+  if (state_ != State::kLoading)
+    return;
+
+  if (streaming_committed_) {
+    QueueStreamingOutput(std::move(output));
+    return;
+  }
+
+  streaming_output_.append(output);
+  if (streaming_output_.length() >= kMinDistilledLength)
+    CommitStreamingOutput();
+}
+
+void SpeedReaderURLLoader::OnStreamingRewriterDone(bool success) {
+  if (state_ != State::kLoading)
+    return;
+
+  VLOG_IF(2, !success) << __func__ << " rewriter failed for " << response_url_;
+  if (!success && streaming_committed_) {
+    // Part of the distilled page has already been sent and the untouched body
+    // is gone, so there is nothing to fall back to.
+    destination_url_loader_client_->OnComplete(
+        network::URLLoaderCompletionStatus(net::ERR_FAILED));
+    body_producer_handle_.reset();
     Abort();
     return;
   }
+  streaming_rewriter_done_ = true;
+  MaybeFinishStreaming();
+}
 
-  buffered_body_ = std::move(body);
+void SpeedReaderURLLoader::CommitStreamingOutput() {
+  DCHECK(!streaming_committed_);
+  streaming_committed_ = true;
+  UMA_HISTOGRAM_TIMES("Brave.Speedreader.StreamingTimeToFirstOutput",
+                      base::TimeTicks::Now() - streaming_start_time_);
+
+  // The untouched body is not needed anymore.
+  std::string().swap(streaming_original_body_);
+  bytes_remaining_in_buffer_ = 0;
+  if (!StartSendingToClient())
+    return;
+
+  std::string output = rewriter_service_
+                           ? rewriter_service_->GetContentStylesheet()
+                           : std::string();
+  output.append(streaming_output_);
+  std::string().swap(streaming_output_);
+  QueueStreamingOutput(std::move(output));
+}
+
+void SpeedReaderURLLoader::QueueStreamingOutput(std::string output) {
+  DCHECK(streaming_committed_);
+  if (output.empty())
+    return;
+
+  const bool write_pending = bytes_remaining_in_buffer_ > 0;
+  if (write_pending) {
+    // Drop what has already been sent before appending.
+    buffered_body_.erase(0, buffered_body_.size() - bytes_remaining_in_buffer_);
+    buffered_body_.append(output);
+  } else {
+    buffered_body_ = std::move(output);
+  }
   bytes_remaining_in_buffer_ = buffered_body_.size();
 
+  // A pending write resumes from OnBodyWritable().
+  if (!write_pending)
+    SendReceivedBodyToClient();
+}
+
+void SpeedReaderURLLoader::MaybeFinishStreaming() {
+  DCHECK_EQ(State::kLoading, state_);
+  if (!streaming_input_ended_ || !streaming_rewriter_done_)
+    return;
+
+  if (!streaming_committed_) {
+    // Not enough has been distilled, send the page as is.
+    std::string body = std::move(streaming_original_body_);
+    CompleteLoading(std::move(body));
+    return;
+  }
+
+  state_ = State::kSending;
+  if (bytes_remaining_in_buffer_ == 0)
+    CompleteSending();
+}
+
+bool SpeedReaderURLLoader::StartSendingToClient() {
+  if (!throttle_) {
+    Abort();
+    return false;
+  }
+
   throttle_->Resume();
   mojo::ScopedDataPipeConsumerHandle body_to_send;
   MojoResult result =
       mojo::CreateDataPipe(nullptr, body_producer_handle_, body_to_send);
   if (result != MOJO_RESULT_OK) {
     Abort();
-    return;
+    return false;
   }
   // Set up the watcher for the producer handle.
   body_producer_watcher_.Watch(
@@ -310,6 +498,18 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   // Send deferred message.
   destination_url_loader_client_->OnStartLoadingResponseBody(
       std::move(body_to_send));
+  return true;
+}
+
+void SpeedReaderURLLoader::CompleteLoading(std::string body) {
+  DCHECK_EQ(State::kLoading, state_);
+  state_ = State::kSending;
+
+  buffered_body_ = std::move(body);
+  bytes_remaining_in_buffer_ = buffered_body_.size();
+
+  if (!StartSendingToClient())
+    return;
 
   DCHECK(bytes_remaining_in_buffer_);
   if (bytes_remaining_in_buffer_) {
@@ -335,7 +535,8 @@ void SpeedReaderURLLoader::CompleteSending() {
 }
 
 void SpeedReaderURLLoader::SendReceivedBodyToClient() {
-  DCHECK_EQ(State::kSending, state_);
+  DCHECK(state_ == State::kSending ||
+         (streaming_ && state_ == State::kLoading));
   // Send the buffered data first.
   DCHECK_GT(bytes_remaining_in_buffer_, 0u);
   size_t start_position = buffered_body_.size() - bytes_remaining_in_buffer_;
@@ -360,6 +561,12 @@ void SpeedReaderURLLoader::SendReceivedBodyToClient() {
   }
   bytes_remaining_in_buffer_ -= bytes_sent;
   body_producer_watcher_.ArmOrNotify();
+
+  if (streaming_read_paused_ &&
+      bytes_remaining_in_buffer_ < kMaxPendingStreamingOutput) {
+    streaming_read_paused_ = false;
+    body_consumer_watcher_.ArmOrNotify();
+  }
 }
 
 void SpeedReaderURLLoader::Abort() {
@@ -6,6 +6,7 @@
 #ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 #define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -13,7 +14,9 @@
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
 #include "base/strings/string_piece.h"
+#include "base/time/time.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/bindings/receiver.h"
@@ -27,6 +30,7 @@ namespace speedreader {
 
 class SpeedReaderThrottle;
 class SpeedreaderRewriterService;
+class SpeedreaderStreamingRewriter;
 
 // Loads the whole response body and tries to Speedreader-distill it.
 // Cargoculted from |`SniffingURLLoader|.
@@ -49,6 +53,18 @@ class SpeedreaderRewriterService;
 // kAborted: Unexpected behavior happens. Watchers, pipes and the binding from
 //           the source loader to |this| are stopped. All incoming messages from
 //           the destination (through network::mojom::URLLoader) are ignored in
+//           this state.
+//
+// With |kSpeedreaderStreamingRewrite| enabled the body is not buffered in
+// kLoading: every chunk is handed to a rewriter running on a background
+// sequence as soon as it is read. The untouched body is only kept until the
+// rewriter has produced enough output to be considered a distilled page; from
+// then on rewritten output is sent to the destination while the source is
+// still being read, and the state changes to kSending once the rewriter is
+// done. Reading from the source is paused while the destination doesn't keep
+// up with the rewritten output. If the rewriter fails or produces too little
+// output before that point, the untouched body is sent exactly as in the
+// buffered mode; if it fails afterwards, the load fails with net::ERR_FAILED.
 class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
                              public network::mojom::URLLoader {
  public:
@@ -63,6 +79,16 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
       mojo::PendingReceiver<network::mojom::URLLoaderClient>
           source_url_client_receiver);
 
+  using StreamingRewriterFactory =
+      base::RepeatingCallback<std::unique_ptr<SpeedreaderStreamingRewriter>(
+          base::RepeatingCallback<void(std::string)> output_callback,
+          base::OnceCallback<void(bool success)> done_callback)>;
+
+  // Makes loaders use |factory| for streaming mode instead of a rewriter from
+  // the rewriter service.
+  static void SetStreamingRewriterFactoryForTesting(
+      StreamingRewriterFactory factory);
+
   // mojo::PendingRemote<network::mojom::URLLoader> controls the lifetime of the
   // loader.
   static std::tuple<mojo::PendingRemote<network::mojom::URLLoader>,
@@ -114,6 +140,18 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
   void OnBodyWritable(MojoResult);
   void MaybeLaunchSpeedreader();
 
+  // Streaming mode, see the class comment.
+  void StartStreamingRewriter();
+  void ReadBodyForStreamingRewriter();
+  void OnStreamingRewriterOutput(std::string output);
+  void OnStreamingRewriterDone(bool success);
+  void CommitStreamingOutput();
+  void QueueStreamingOutput(std::string output);
+  void MaybeFinishStreaming();
+
+  // Resumes the throttle and hands the body pipe to the destination. Returns
+  // false if |this| was aborted.
+  bool StartSendingToClient();
   // Gets either distilled or untouched body.
   void CompleteLoading(std::string body);
   void CompleteSending();
@@ -140,13 +178,28 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
 
   // Note that this could be replaced by a distilled version.
   std::string buffered_body_;
-  size_t bytes_remaining_in_buffer_;
+  size_t bytes_remaining_in_buffer_ = 0;
 
   mojo::ScopedDataPipeConsumerHandle body_consumer_handle_;
   mojo::ScopedDataPipeProducerHandle body_producer_handle_;
   mojo::SimpleWatcher body_consumer_watcher_;
   mojo::SimpleWatcher body_producer_watcher_;
 
+  // Streaming mode state.
+  bool streaming_ = false;
+  bool streaming_committed_ = false;
+  bool streaming_input_ended_ = false;
+  bool streaming_rewriter_done_ = false;
+  bool streaming_read_paused_ = false;
+  // Untouched body, released once the rewritten output is committed to.
+  std::string streaming_original_body_;
+  // Rewritten output received before committing to it.
+  std::string streaming_output_;
+  base::TimeTicks streaming_start_time_;
+  scoped_refptr<base::SequencedTaskRunner> rewriter_task_runner_;
+  std::unique_ptr<SpeedreaderStreamingRewriter, base::OnTaskRunnerDeleter>
+      streaming_rewriter_{nullptr, base::OnTaskRunnerDeleter(nullptr)};
+
   // Not Owned
   SpeedreaderRewriterService* rewriter_service_;
 
@@ -0,0 +1,205 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_url_loader.h"
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "brave/components/speedreader/features.h"
+#include "brave/components/speedreader/speedreader_streaming_rewriter.h"
+#include "brave/components/speedreader/speedreader_throttle.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "mojo/public/cpp/bindings/pending_remote.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "mojo/public/cpp/system/data_pipe_utils.h"
+#include "net/base/net_errors.h"
+#include "services/network/public/cpp/url_loader_completion_status.h"
+#include "services/network/test/test_url_loader_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace speedreader {
+
+namespace {
+
+constexpr char kOriginalBody[] = "<html><body>original</body></html>";
+
+// Output is driven by the test through the callbacks handed to the factory.
+class FakeStreamingRewriter : public SpeedreaderStreamingRewriter {
+ public:
+  FakeStreamingRewriter() = default;
+  ~FakeStreamingRewriter() override = default;
+
+  void Write(std::string chunk) override {}
+  void End() override {}
+};
+
+class TestThrottleDelegate : public blink::URLLoaderThrottle::Delegate {
+ public:
+  void CancelWithError(int error_code,
+                       base::StringPiece custom_reason) override {}
+  void Resume() override { resumed_ = true; }
+
+  bool resumed() const { return resumed_; }
+
+ private:
+  bool resumed_ = false;
+};
+
+}  // namespace
+
+class SpeedReaderURLLoaderTest : public testing::Test {
+ public:
+  SpeedReaderURLLoaderTest()
+      : throttle_(nullptr, base::ThreadTaskRunnerHandle::Get()) {}
+
+ protected:
+  void SetUp() override {
+    feature_list_.InitAndEnableFeature(kSpeedreaderStreamingRewrite);
+    SpeedReaderURLLoader::SetStreamingRewriterFactoryForTesting(
+        base::BindRepeating(&SpeedReaderURLLoaderTest::MakeStreamingRewriter,
+                            base::Unretained(this)));
+    throttle_.set_delegate(&throttle_delegate_);
+  }
+
+  void TearDown() override {
+    SpeedReaderURLLoader::SetStreamingRewriterFactoryForTesting(
+        SpeedReaderURLLoader::StreamingRewriterFactory());
+  }
+
+  std::unique_ptr<SpeedreaderStreamingRewriter> MakeStreamingRewriter(
+      base::RepeatingCallback<void(std::string)> output_callback,
+      base::OnceCallback<void(bool)> done_callback) {
+    output_callback_ = std::move(output_callback);
+    done_callback_ = std::move(done_callback);
+    return std::make_unique<FakeStreamingRewriter>();
+  }
+
+  // Starts a load and sends |kOriginalBody| through the source pipe.
+  void StartLoading() {
+    mojo::PendingReceiver<network::mojom::URLLoaderClient>
+        destination_client_receiver;
+    SpeedReaderURLLoader* loader;
+    std::tie(loader_, destination_client_receiver, loader) =
+        SpeedReaderURLLoader::CreateLoader(
+            throttle_weak_factory_.GetWeakPtr(),
+            GURL("https://example.com/article"),
+            base::ThreadTaskRunnerHandle::Get(), nullptr);
+    ASSERT_TRUE(mojo::FusePipes(std::move(destination_client_receiver),
+                                destination_client_.CreateRemote()));
+
+    mojo::PendingRemote<network::mojom::URLLoader> source_loader;
+    std::ignore = source_loader.InitWithNewPipeAndPassReceiver();
+    loader->Start(std::move(source_loader),
+                  source_client_.BindNewPipeAndPassReceiver());
+
+    mojo::ScopedDataPipeProducerHandle producer;
+    mojo::ScopedDataPipeConsumerHandle consumer;
+    ASSERT_EQ(MOJO_RESULT_OK,
+              mojo::CreateDataPipe(nullptr, producer, consumer));
+    source_client_->OnStartLoadingResponseBody(std::move(consumer));
+    ASSERT_TRUE(mojo::BlockingCopyFromString(kOriginalBody, producer));
+    producer.reset();
+    task_environment_.RunUntilIdle();
+    ASSERT_TRUE(output_callback_);
+  }
+
+  std::string ReadDestinationBody() {
+    std::string body;
+    EXPECT_TRUE(mojo::BlockingCopyToString(
+        destination_client_.response_body_release(), &body));
+    return body;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::test::ScopedFeatureList feature_list_;
+
+  TestThrottleDelegate throttle_delegate_;
+  SpeedReaderThrottle throttle_;
+  base::WeakPtrFactory<SpeedReaderThrottle> throttle_weak_factory_{&throttle_};
+
+  mojo::PendingRemote<network::mojom::URLLoader> loader_;
+  mojo::Remote<network::mojom::URLLoaderClient> source_client_;
+  network::TestURLLoaderClient destination_client_;
+
+  base::RepeatingCallback<void(std::string)> output_callback_;
+  base::OnceCallback<void(bool)> done_callback_;
+};
+
+TEST_F(SpeedReaderURLLoaderTest, StreamsDistilledOutput) {
+  StartLoading();
+  EXPECT_FALSE(throttle_delegate_.resumed());
+
+  // Enough output to be considered distilled.
+  const std::string distilled(2048, 'x');
+  output_callback_.Run(distilled);
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(throttle_delegate_.resumed());
+  EXPECT_TRUE(destination_client_.response_body().is_valid());
+
+  output_callback_.Run("tail");
+  std::move(done_callback_).Run(true);
+  source_client_->OnComplete(network::URLLoaderCompletionStatus(net::OK));
+  destination_client_.RunUntilComplete();
+
+  EXPECT_EQ(net::OK, destination_client_.completion_status().error_code);
+  EXPECT_EQ(distilled + "tail", ReadDestinationBody());
+}
+
+TEST_F(SpeedReaderURLLoaderTest, SendsOriginalBodyBelowThreshold) {
+  StartLoading();
+
+  output_callback_.Run("too short");
+  std::move(done_callback_).Run(true);
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(throttle_delegate_.resumed());
+
+  source_client_->OnComplete(network::URLLoaderCompletionStatus(net::OK));
+  destination_client_.RunUntilComplete();
+
+  EXPECT_EQ(net::OK, destination_client_.completion_status().error_code);
+  EXPECT_EQ(kOriginalBody, ReadDestinationBody());
+}
+
+TEST_F(SpeedReaderURLLoaderTest, FailsLoadIfRewriterFailsAfterCommit) {
+  StartLoading();
+
+  output_callback_.Run(std::string(2048, 'x'));
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(throttle_delegate_.resumed());
+
+  // The untouched body is gone, the client must not get a truncated page as
+  // if it was complete.
+  std::move(done_callback_).Run(false);
+  destination_client_.RunUntilComplete();
+
+  EXPECT_EQ(net::ERR_FAILED,
+            destination_client_.completion_status().error_code);
+}
+
+TEST_F(SpeedReaderURLLoaderTest, DefersOnCompleteUntilRewriterIsDone) {
+  StartLoading();
+
+  const std::string distilled(2048, 'x');
+  output_callback_.Run(distilled);
+  source_client_->OnComplete(network::URLLoaderCompletionStatus(net::OK));
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(destination_client_.has_received_completion());
+
+  std::move(done_callback_).Run(true);
+  destination_client_.RunUntilComplete();
+
+  EXPECT_EQ(net::OK, destination_client_.completion_status().error_code);
+  EXPECT_EQ(distilled, ReadDestinationBody());
+}
+
+}  // namespace speedreader
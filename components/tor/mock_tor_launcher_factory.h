@@ -25,6 +25,7 @@ class MockTorLauncherFactory : public TorLauncherFactory {
   MOCK_METHOD(int64_t, GetTorPid, (), (const override));
   MOCK_METHOD(bool, IsTorConnected, (), (const override));
   MOCK_METHOD(std::string, GetTorProxyURI, (), (const override));
+  MOCK_METHOD(void, PrewarmCircuit, (), (override));
 
  private:
   friend class base::NoDestructor<MockTorLauncherFactory>;
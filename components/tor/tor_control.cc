@@ -43,6 +43,8 @@ constexpr char kGetSOCKSListenersReply[] = "net/listeners/socks=";
 constexpr char kGetCircuitEstablishedCmd[] =
     "GETINFO status/circuit-established";
 constexpr char kGetCircuitEstablishedReply[] = "status/circuit-established=";
+constexpr char kExtendCircuitCmd[] = "EXTENDCIRCUIT 0";
+constexpr char kExtendCircuitReply[] = "EXTENDED ";
 
 static std::string escapify(const char* buf, int len) {
   std::ostringstream s;
@@ -328,9 +330,8 @@ std::string TorControl::SetEventsCmd() {
   std::ostringstream cmds;
   cmds << "SETEVENTS";
   for (const auto& entry : async_events_) {
-    const auto& found = kTorControlEventByEnum.find(entry.first);
-    DCHECK(found != kTorControlEventByEnum.end());
-    cmds << " " << (*found).second;
+    DCHECK_NE(entry.first, TorControlEvent::INVALID);
+    cmds << " " << GetTorControlEventName(entry.first);
   }
   return cmds.str();
 }
@@ -516,6 +517,45 @@ void TorControl::GetCircuitEstablishedDone(
   std::move(callback).Run(false, result);
 }
 
+// ExtendCircuit(callback)
+//
+//      Build a new circuit on a path of Tor's choosing and call
+//      callback(error, circuit_id) once Tor has accepted the request.
+//      The circuit may still be under construction at that point.
+//
+void TorControl::ExtendCircuit(
+    base::OnceCallback<void(bool error, const std::string& circuit_id)>
+        callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
+  io_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          &TorControl::DoCmd, weak_ptr_factory_.GetWeakPtr(),
+          kExtendCircuitCmd,
+          base::DoNothing::Repeatedly<const std::string&,
+                                      const std::string&>(),
+          base::BindOnce(&TorControl::ExtendCircuitDone,
+                         weak_ptr_factory_.GetWeakPtr(), std::move(callback))));
+}
+
+void TorControl::ExtendCircuitDone(
+    base::OnceCallback<void(bool error, const std::string& circuit_id)>
+        callback,
+    bool error,
+    const std::string& status,
+    const std::string& reply) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  if (error || status != "250" ||
+      !base::StartsWith(reply, kExtendCircuitReply,
+                        base::CompareCase::SENSITIVE) ||
+      reply.size() == strlen(kExtendCircuitReply)) {
+    VLOG_IF(0, !error) << "tor: unexpected " << kExtendCircuitCmd << " reply";
+    std::move(callback).Run(true, "");
+    return;
+  }
+  std::move(callback).Run(false, reply.substr(strlen(kExtendCircuitReply)));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Writing state machine
 
@@ -716,8 +756,10 @@ void TorControl::ReadDone(int rv) {
         // CRLF seen, so we must have i >= 2.  Emit a line and advance
         // to the next one, unless anything went wrong with the line.
         assert(i >= 1);
-        std::string line(readiobuf_->StartOfBuffer() + read_start_,
-                         readiobuf_->offset() + i - 1 - read_start_);
+        // The line is parsed in place, without copying it out of the
+        // buffer.
+        base::StringPiece line(readiobuf_->StartOfBuffer() + read_start_,
+                               readiobuf_->offset() + i - 1 - read_start_);
         read_start_ = readiobuf_->offset() + i + 1;
         read_cr_ = false;
         if (!ReadLine(line)) {
@@ -773,7 +815,7 @@ void TorControl::ReadDone(int rv) {
 //      We have read a line of input; process it.  Return true on
 //      success, false on error.
 //
-bool TorControl::ReadLine(const std::string& line) {
+bool TorControl::ReadLine(base::StringPiece line) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
 
   if (line.size() < 4) {
@@ -788,9 +830,9 @@ bool TorControl::ReadLine(const std::string& line) {
   // intermediate reply and ` ' for a final reply.
   //
   // TODO(riastradh): parse or check syntax of status
-  std::string status(line, 0, 3);
-  char pos = line[3];
-  std::string reply(line, 4);
+  const base::StringPiece status = line.substr(0, 3);
+  const char pos = line[3];
+  const base::StringPiece reply = line.substr(4);
 
   // Determine whether it is an asynchronous reply, status 6yz.
   if (status[0] == '6') {
@@ -801,13 +843,14 @@ bool TorControl::ReadLine(const std::string& line) {
     if (!async_) {
       // Parse the keyword and the initial line.
       const size_t sp = reply.find(' ');
-      std::string event_name, initial;
-      if (sp == std::string::npos) {
+      base::StringPiece event_name, initial;
+      if (sp == base::StringPiece::npos) {
         event_name = reply;
       } else {
         event_name = reply.substr(0, sp);
         initial = reply.substr(sp + 1);
       }
+      const TorControlEvent event = GetTorControlEventByName(event_name);
 
       // Discriminate on the position of the reply.
       switch (pos) {
@@ -815,12 +858,10 @@ bool TorControl::ReadLine(const std::string& line) {
           // Single-line async reply.
 
           // Bail if we don't recognize the event name.
-          const auto& found = kTorControlEventByName.find(event_name);
-          if (found == kTorControlEventByName.end()) {
+          if (event == TorControlEvent::INVALID) {
             VLOG(1) << "tor: unknown event: " << event_name;  // XXX escape
             return false;
           }
-          const TorControlEvent event = (*found).second;
 
           // Ignore if we don't think we're subscribed to this.
           if (!async_events_.count(event)) {
@@ -830,7 +871,7 @@ bool TorControl::ReadLine(const std::string& line) {
 
           // Notify the delegate of the parsed reply.  No extra
           // because there were no intermediate reply lines.
-          NotifyTorEvent(event, initial, {});
+          NotifyTorEvent(event, initial.as_string(), {});
 
           return true;
         }
@@ -839,13 +880,9 @@ bool TorControl::ReadLine(const std::string& line) {
 
           // Start a fresh async reply state.  Parse the rest, but
           // skip it, if we don't recognize the event.
-          const auto& found = kTorControlEventByName.find(event_name);
-          const TorControlEvent event =
-              (found == kTorControlEventByName.end() ? TorControlEvent::INVALID
-                                                     : (*found).second);
           async_ = std::make_unique<Async>();
           async_->event = event;
-          async_->initial = initial;
+          async_->initial = initial.as_string();
           async_->skip = (event == TorControlEvent::INVALID);
           return true;
         }
@@ -873,12 +910,12 @@ bool TorControl::ReadLine(const std::string& line) {
             Error();
             return false;
           }
-          if (async_->extra.count(key)) {
+          if (!async_->extra.emplace(std::move(key), std::move(value))
+                   .second) {
             VLOG(1) << "tor: duplicate key in async continuation line";
             Error();
             return false;
           }
-          async_->extra[key] = value;
           return true;
         }
         case ' ': {
@@ -891,12 +928,12 @@ bool TorControl::ReadLine(const std::string& line) {
               Error();
               return false;
             }
-            if (async_->extra.count(key)) {
+            if (!async_->extra.emplace(std::move(key), std::move(value))
+                     .second) {
               VLOG(1) << "tor: duplicate key in async event";
               Error();
               return false;
             }
-            async_->extra[key] = value;
 
             // If we're still subscribed, notify the delegate of the
             // parsed reply.
@@ -917,7 +954,7 @@ bool TorControl::ReadLine(const std::string& line) {
         NotifyTorRawMid(status, reply);
         if (!cmdq_.empty()) {
           PerLineCallback& perline = cmdq_.front().first;
-          perline.Run(status, reply);
+          perline.Run(status.as_string(), reply.as_string());
         }
         return true;
       case '+':
@@ -929,7 +966,8 @@ bool TorControl::ReadLine(const std::string& line) {
         if (!cmdq_.empty()) {
           CmdCallback& callback = cmdq_.front().second;
           bool error = false;
-          std::move(callback).Run(error, status, reply);
+          std::move(callback).Run(error, status.as_string(),
+                                  reply.as_string());
           cmdq_.pop();
         }
         return true;
@@ -1007,28 +1045,28 @@ void TorControl::NotifyTorRawCmd(const std::string& cmd) {
       FROM_HERE, base::BindOnce(&Delegate::OnTorRawCmd, delegate_, cmd));
 }
 
-void TorControl::NotifyTorRawAsync(const std::string& status,
-                                   const std::string& line) {
+void TorControl::NotifyTorRawAsync(base::StringPiece status,
+                                   base::StringPiece line) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   owner_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&Delegate::OnTorRawAsync, delegate_, status, line));
+      FROM_HERE, base::BindOnce(&Delegate::OnTorRawAsync, delegate_,
+                                status.as_string(), line.as_string()));
 }
 
-void TorControl::NotifyTorRawMid(const std::string& status,
-                                 const std::string& line) {
+void TorControl::NotifyTorRawMid(base::StringPiece status,
+                                 base::StringPiece line) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   owner_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&Delegate::OnTorRawMid, delegate_, status, line));
+      FROM_HERE, base::BindOnce(&Delegate::OnTorRawMid, delegate_,
+                                status.as_string(), line.as_string()));
 }
 
-void TorControl::NotifyTorRawEnd(const std::string& status,
-                                 const std::string& line) {
+void TorControl::NotifyTorRawEnd(base::StringPiece status,
+                                 base::StringPiece line) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   owner_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&Delegate::OnTorRawEnd, delegate_, status, line));
+      FROM_HERE, base::BindOnce(&Delegate::OnTorRawEnd, delegate_,
+                                status.as_string(), line.as_string()));
 }
 
 // ParseKV(string, key, value)
@@ -1038,7 +1076,7 @@ void TorControl::NotifyTorRawEnd(const std::string& status,
 //      success, false on failure.
 //
 // static
-bool TorControl::ParseKV(const std::string& string,
+bool TorControl::ParseKV(base::StringPiece string,
                          std::string* key,
                          std::string* value) {
   size_t end;
@@ -1053,21 +1091,21 @@ bool TorControl::ParseKV(const std::string& string,
 //      failure.
 //
 // static
-bool TorControl::ParseKV(const std::string& string,
+bool TorControl::ParseKV(base::StringPiece string,
                          std::string* key,
                          std::string* value,
                          size_t* end) {
   DCHECK(key && value && end);
   // Search for `=' -- it had better be there.
-  size_t eq = string.find("=");
-  if (eq == std::string::npos)
+  size_t eq = string.find('=');
+  if (eq == base::StringPiece::npos)
     return false;
   size_t vstart = eq + 1;
 
   // If we're at the end of the string, value is empt.
   if (vstart == string.size()) {
-    *key = string.substr(0, eq);
-    *value = "";
+    string.substr(0, eq).CopyToString(key);
+    value->clear();
     *end = string.size();
     return true;
   }
@@ -1076,7 +1114,7 @@ bool TorControl::ParseKV(const std::string& string,
   if (string[vstart] != '"') {
     // Not quoted.  Check for a delimiter.
     size_t i, vend = string.size();
-    if ((i = string.find(" ", vstart)) != std::string::npos) {
+    if ((i = string.find(' ', vstart)) != base::StringPiece::npos) {
       // Delimited.  Stop at the delimiter, and consume it.
       vend = i;
       *end = vend + 1;
@@ -1086,19 +1124,19 @@ bool TorControl::ParseKV(const std::string& string,
     }
 
     // Check for internal quotes; they are forbidden.
-    if ((i = string.find("\"", vstart)) != std::string::npos)
+    if ((i = string.find('"', vstart)) != base::StringPiece::npos)
       return false;
 
     // Extract the key and value and we're done.
-    *key = string.substr(0, eq);
-    *value = string.substr(vstart, vend - vstart);
+    string.substr(0, eq).CopyToString(key);
+    string.substr(vstart, vend - vstart).CopyToString(value);
     return true;
   }
 
   // Quoted string.  Parse it, and consume trailing spaces.
   if (!ParseQuoted(string.substr(eq + 1), value, end))
     return false;
-  *key = string.substr(0, eq);
+  string.substr(0, eq).CopyToString(key);
   *end += eq + 1;
   while (*end < string.size() && string[*end] == ' ')
     (*end)++;
@@ -1113,7 +1151,7 @@ bool TorControl::ParseKV(const std::string& string,
 //      return false on failure.
 //
 // static
-bool TorControl::ParseQuoted(const std::string& string,
+bool TorControl::ParseQuoted(base::StringPiece string,
                              std::string* value,
                              size_t* end) {
   enum {
@@ -1125,8 +1163,11 @@ bool TorControl::ParseQuoted(const std::string& string,
     OCTAL1,
     OCTAL2,
   } S = START;
-  std::string buf(string.size(), '\0');
-  size_t i, pos = 0;
+  // Unescape straight into |value|, it is only valid on success.
+  std::string& buf = *value;
+  buf.clear();
+  buf.reserve(string.size());
+  size_t i;
   unsigned octal;
 
   for (i = 0; i < string.size(); i++) {
@@ -1153,7 +1194,7 @@ bool TorControl::ParseQuoted(const std::string& string,
             S = ACCEPT;
             break;
           default:
-            buf[pos++] = ch;
+            buf.push_back(ch);
             S = BODY;
             break;
         }
@@ -1172,21 +1213,21 @@ bool TorControl::ParseQuoted(const std::string& string,
             S = OCTAL1;
             break;
           case 'n':
-            buf[pos++] = '\n';
+            buf.push_back('\n');
             S = BODY;
             break;
           case 'r':
-            buf[pos++] = '\r';
+            buf.push_back('\r');
             S = BODY;
             break;
           case 't':
-            buf[pos++] = '\t';
+            buf.push_back('\t');
             S = BODY;
             break;
           case '\\':
           case '"':
           case '\'':
-            buf[pos++] = ch;
+            buf.push_back(ch);
             S = BODY;
             break;
           default:
@@ -1223,7 +1264,7 @@ bool TorControl::ParseQuoted(const std::string& string,
           case '6':
           case '7':
             octal |= (ch - '0');
-            buf[pos++] = octal;
+            buf.push_back(octal);
             S = BODY;
             break;
           default:
@@ -1238,7 +1279,6 @@ bool TorControl::ParseQuoted(const std::string& string,
       case REJECT:
         return false;
       case ACCEPT:
-        *value = buf.substr(0, pos);
         *end = i + 1;
         return true;
       default:
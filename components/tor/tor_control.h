@@ -18,6 +18,7 @@
 #include "base/callback.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
 
 namespace base {
 class SequencedTaskRunner;
@@ -92,6 +93,11 @@ class TorControl {
           callback);
   void GetCircuitEstablished(
       base::OnceCallback<void(bool error, bool established)> callback);
+  // Asks Tor to build a new general purpose circuit. The circuit is not bound
+  // to any isolation key until the first stream is attached to it.
+  void ExtendCircuit(
+      base::OnceCallback<void(bool error, const std::string& circuit_id)>
+          callback);
 
  protected:
   friend class TorControlTest;
@@ -99,15 +105,16 @@ class TorControl {
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ParseKV);
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ReadLine);
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, GetCircuitEstablishedDone);
+  FRIEND_TEST_ALL_PREFIXES(TorControlTest, ExtendCircuitDone);
 
-  static bool ParseKV(const std::string& string,
+  static bool ParseKV(base::StringPiece string,
                       std::string* key,
                       std::string* value);
-  static bool ParseKV(const std::string& string,
+  static bool ParseKV(base::StringPiece string,
                       std::string* key,
                       std::string* value,
                       size_t* end);
-  static bool ParseQuoted(const std::string& string,
+  static bool ParseQuoted(base::StringPiece string,
                           std::string* value,
                           size_t* end);
 
@@ -149,6 +156,12 @@ class TorControl {
       bool error,
       const std::string& status,
       const std::string& reply);
+  void ExtendCircuitDone(
+      base::OnceCallback<void(bool error, const std::string& circuit_id)>
+          callback,
+      bool error,
+      const std::string& status,
+      const std::string& reply);
 
   void DoSubscribe(TorControlEvent event,
                    base::OnceCallback<void(bool error)> callback);
@@ -174,9 +187,9 @@ class TorControl {
                       const std::string& initial,
                       const std::map<std::string, std::string>& extra);
   void NotifyTorRawCmd(const std::string& cmd);
-  void NotifyTorRawAsync(const std::string& status, const std::string& line);
-  void NotifyTorRawMid(const std::string& status, const std::string& line);
-  void NotifyTorRawEnd(const std::string& status, const std::string& line);
+  void NotifyTorRawAsync(base::StringPiece status, base::StringPiece line);
+  void NotifyTorRawMid(base::StringPiece status, base::StringPiece line);
+  void NotifyTorRawEnd(base::StringPiece status, base::StringPiece line);
 
   void StartWrite();
   void DoWrites();
@@ -187,7 +200,7 @@ class TorControl {
   void DoReads();
   void ReadDoneAsync(int rv);
   void ReadDone(int rv);
-  bool ReadLine(const std::string& line);
+  bool ReadLine(base::StringPiece line);
 
   void Error();
 
@@ -5,19 +5,50 @@
 
 #include "brave/components/tor/tor_control_event.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace tor {
 
-const std::map<std::string, TorControlEvent> kTorControlEventByName = {
+namespace {
+
+struct TorControlEventName {
+  base::StringPiece name;
+  TorControlEvent event;
+};
+
+// tor_control_event_list.h is kept sorted by name so this table can be
+// binary searched without building a map at startup.
+constexpr TorControlEventName kTorControlEventNames[] = {
 #define TOR_EVENT(N) {#N, TorControlEvent::N},
 #include "tor_control_event_list.h"  // NOLINT
 #undef TOR_EVENT
 };
 
-const std::map<TorControlEvent, std::string> kTorControlEventByEnum = {
-  {TorControlEvent::INVALID, "(invalid)"},
-#define TOR_EVENT(N) {TorControlEvent::N, #N},
+}  // namespace
+
+TorControlEvent GetTorControlEventByName(base::StringPiece name) {
+  const auto* it = std::lower_bound(
+      std::begin(kTorControlEventNames), std::end(kTorControlEventNames), name,
+      [](const TorControlEventName& entry, base::StringPiece value) {
+        return entry.name < value;
+      });
+  if (it == std::end(kTorControlEventNames) || it->name != name)
+    return TorControlEvent::INVALID;
+  return it->event;
+}
+
+const char* GetTorControlEventName(TorControlEvent event) {
+  switch (event) {
+    case TorControlEvent::INVALID:
+      return "(invalid)";
+#define TOR_EVENT(N)         \
+  case TorControlEvent::N: \
+    return #N;
 #include "tor_control_event_list.h"  // NOLINT
 #undef TOR_EVENT
-};
+  }
+  return "(invalid)";
+}
 
 }  // namespace tor
@@ -6,8 +6,7 @@
 #ifndef BRAVE_COMPONENTS_TOR_TOR_CONTROL_EVENT_H_
 #define BRAVE_COMPONENTS_TOR_TOR_CONTROL_EVENT_H_
 
-#include <map>
-#include <string>
+#include "base/strings/string_piece.h"
 
 namespace tor {
 
@@ -18,8 +17,9 @@ enum class TorControlEvent {
 #undef TOR_EVENT
 };
 
-extern const std::map<std::string, TorControlEvent> kTorControlEventByName;
-extern const std::map<TorControlEvent, std::string> kTorControlEventByEnum;
+// Returns TorControlEvent::INVALID for unknown event names.
+TorControlEvent GetTorControlEventByName(base::StringPiece name);
+const char* GetTorControlEventName(TorControlEvent event);
 
 }  // namespace tor
 
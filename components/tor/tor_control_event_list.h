@@ -6,6 +6,8 @@
 // NOLINT(build/header_guard)
 // no-include-guard-because-multiply-included
 
+// Keep sorted by name, GetTorControlEventByName() relies on it.
+
 TOR_EVENT(ADDRMAP)
 TOR_EVENT(AUTHDIR_NEWDESCS)
 TOR_EVENT(BUILDTIMEOUT_SET)
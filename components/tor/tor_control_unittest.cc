@@ -30,6 +30,18 @@ class MockTorControlDelegate : public TorControl::Delegate {
 };
 }  // namespace
 
+TEST(TorControlTest, GetTorControlEventByName) {
+#define TOR_EVENT(N)                                          \
+  EXPECT_EQ(GetTorControlEventByName(#N), TorControlEvent::N); \
+  EXPECT_STREQ(GetTorControlEventName(TorControlEvent::N), #N);
+#include "brave/components/tor/tor_control_event_list.h"  // NOLINT
+#undef TOR_EVENT
+  EXPECT_EQ(GetTorControlEventByName(""), TorControlEvent::INVALID);
+  EXPECT_EQ(GetTorControlEventByName("CIRC_"), TorControlEvent::INVALID);
+  EXPECT_EQ(GetTorControlEventByName("circ"), TorControlEvent::INVALID);
+  EXPECT_EQ(GetTorControlEventByName("ZZZ"), TorControlEvent::INVALID);
+}
+
 TEST(TorControlTest, ParseQuoted) {
   const struct {
     const char* input;
@@ -300,4 +312,50 @@ TEST(TorControlTest, GetCircuitEstablishedDone) {
   base::RunLoop().RunUntilIdle();
 }
 
+TEST(TorControlTest, ExtendCircuitDone) {
+  content::BrowserTaskEnvironment task_environment;
+  scoped_refptr<base::SequencedTaskRunner> io_task_runner =
+      content::GetIOThreadTaskRunner({});
+
+  MockTorControlDelegate delegate;
+  std::unique_ptr<TorControl> control =
+      std::make_unique<TorControl>(delegate.AsWeakPtr(), io_task_runner);
+
+  io_task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](std::unique_ptr<TorControl> control) {
+            const struct {
+              bool error;
+              const char* status;
+              const char* reply;
+              bool expected_error;
+              const char* expected_circuit_id;
+            } cases[] = {
+                {false, "250", "EXTENDED 42", false, "42"},
+                {true, "250", "EXTENDED 42", true, ""},
+                {false, "552", "Unknown circuit \"0\"", true, ""},
+                {false, "250", "EXTENDED ", true, ""},
+                {false, "250", "OK", true, ""},
+            };
+            for (const auto& c : cases) {
+              bool is_called = false;
+              control->ExtendCircuitDone(
+                  base::BindOnce(
+                      [](bool* is_called, bool expected_error,
+                         const std::string& expected_circuit_id, bool error,
+                         const std::string& circuit_id) {
+                        *is_called = true;
+                        EXPECT_EQ(error, expected_error);
+                        EXPECT_EQ(circuit_id, expected_circuit_id);
+                      },
+                      &is_called, c.expected_error, c.expected_circuit_id),
+                  c.error, c.status, c.reply);
+              EXPECT_TRUE(is_called) << c.reply;
+            }
+          },
+          std::move(control)));
+  base::RunLoop().RunUntilIdle();
+}
+
 }  // namespace tor
@@ -11,6 +11,7 @@
 #include "base/bind_post_task.h"
 #include "base/files/file_util.h"
 #include "base/sequenced_task_runner.h"
+#include "base/strings/string_split.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
 #include "base/threading/sequenced_task_runner_handle.h"
@@ -31,6 +32,15 @@ constexpr char kStatusClientBootstrap[] = "BOOTSTRAP";
 constexpr char kStatusClientBootstrapProgress[] = "PROGRESS=";
 constexpr char kStatusClientCircuitEstablished[] = "CIRCUIT_ESTABLISHED";
 constexpr char kStatusClientCircuitNotEstablished[] = "CIRCUIT_NOT_ESTABLISHED";
+// tor::TorControlEvent::STREAM statuses meaning a circuit was picked for it
+constexpr char kStreamSentConnect[] = "SENTCONNECT";
+constexpr char kStreamSentResolve[] = "SENTRESOLVE";
+// Upper bound of unused circuits kept around by PrewarmCircuit().
+constexpr size_t kMaxPrewarmedCircuits = 3;
+// Tor closes clean circuits which stay unused for a while, forget about them
+// before that happens.
+constexpr base::TimeDelta kPrewarmedCircuitLifetime =
+    base::TimeDelta::FromMinutes(10);
 
 std::pair<bool, std::string> LoadTorLogOnFileTaskRunner(
     const base::FilePath& path) {
@@ -139,6 +149,7 @@ void TorLauncherFactory::KillTorProcess() {
   tor_launcher_.reset();
   tor_pid_ = -1;
   is_connected_ = false;
+  prewarmed_circuits_.clear();
 }
 
 int64_t TorLauncherFactory::GetTorPid() const {
@@ -175,6 +186,70 @@ void TorLauncherFactory::GetTorLog(GetLogCallback callback) {
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
 }
 
+void TorLauncherFactory::PrewarmCircuit() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!is_connected_)
+    return;
+
+  ClearExpiredPrewarmedCircuits();
+  if (prewarmed_circuits_.size() + pending_prewarmed_circuits_ >=
+      kMaxPrewarmedCircuits)
+    return;
+
+  pending_prewarmed_circuits_++;
+  control_->ExtendCircuit(
+      base::BindPostTask(base::SequencedTaskRunnerHandle::Get(),
+                         base::BindOnce(&TorLauncherFactory::OnCircuitPrewarmed,
+                                        weak_ptr_factory_.GetWeakPtr())));
+}
+
+size_t TorLauncherFactory::GetPrewarmedCircuitCountForTesting() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return prewarmed_circuits_.size();
+}
+
+void TorLauncherFactory::OnCircuitPrewarmed(bool error,
+                                            const std::string& circuit_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (pending_prewarmed_circuits_ > 0)
+    pending_prewarmed_circuits_--;
+  if (error) {
+    VLOG(1) << "Failed to prewarm circuit!";
+    return;
+  }
+  VLOG(2) << "Prewarmed circuit " << circuit_id;
+  prewarmed_circuits_[circuit_id] = base::TimeTicks::Now();
+}
+
+void TorLauncherFactory::MaybeConsumePrewarmedCircuit(
+    const std::string& stream_event) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (prewarmed_circuits_.empty())
+    return;
+  // StreamID SP StreamStatus SP CircuitID SP Target ...
+  const std::vector<base::StringPiece> fields = base::SplitStringPiece(
+      stream_event, " ", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (fields.size() < 3)
+    return;
+  if (fields[1] != kStreamSentConnect && fields[1] != kStreamSentResolve)
+    return;
+  // Tor has bound the circuit to this stream's isolation key.
+  prewarmed_circuits_.erase(fields[2].as_string());
+}
+
+void TorLauncherFactory::ClearExpiredPrewarmedCircuits() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const base::TimeTicks cutoff =
+      base::TimeTicks::Now() - kPrewarmedCircuitLifetime;
+  for (auto it = prewarmed_circuits_.begin();
+       it != prewarmed_circuits_.end();) {
+    if (it->second < cutoff)
+      it = prewarmed_circuits_.erase(it);
+    else
+      ++it;
+  }
+}
+
 void TorLauncherFactory::AddObserver(TorLauncherObserver* observer) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   observers_.AddObserver(observer);
@@ -300,6 +375,7 @@ void TorLauncherFactory::GotCircuitEstablished(bool error, bool established) {
 void TorLauncherFactory::OnTorControlClosed(bool was_running) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   VLOG(2) << "TOR CONTROL: Closed!";
+  prewarmed_circuits_.clear();
   // If we're still running, try watching again to start over.
   // TODO(riastradh-brave): Rate limit in case of flapping?
   if (was_running) {
@@ -354,11 +430,13 @@ void TorLauncherFactory::OnTorEvent(
     const std::map<std::string, std::string>& extra) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   const std::string raw_event =
-      (*tor::kTorControlEventByEnum.find(event)).second + ": " + initial;
+      std::string(tor::GetTorControlEventName(event)) + ": " + initial;
   VLOG(3) << "TOR CONTROL: event " << raw_event;
   for (auto& observer : observers_)
     observer.OnTorControlEvent(raw_event);
-  if (event == tor::TorControlEvent::STATUS_CLIENT) {
+  if (event == tor::TorControlEvent::STREAM) {
+    MaybeConsumePrewarmedCircuit(initial);
+  } else if (event == tor::TorControlEvent::STATUS_CLIENT) {
     if (initial.find(kStatusClientBootstrap) != std::string::npos) {
       size_t progress_start = initial.find(kStatusClientBootstrapProgress);
       size_t progress_length = initial.substr(progress_start).find(" ");
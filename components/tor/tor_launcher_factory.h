@@ -17,6 +17,7 @@
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "base/sequence_checker.h"
+#include "base/time/time.h"
 #include "brave/components/services/tor/public/interfaces/tor.mojom.h"
 #include "brave/components/tor/tor_control.h"
 #include "mojo/public/cpp/bindings/remote.h"
@@ -27,6 +28,7 @@ struct OnTaskRunnerDeleter;
 }  // namespace base
 
 class MockTorLauncherFactory;
+class TorLauncherFactoryTest;
 class TorLauncherObserver;
 
 class TorLauncherFactory : public tor::TorControl::Delegate {
@@ -42,6 +44,11 @@ class TorLauncherFactory : public tor::TorControl::Delegate {
   virtual std::string GetTorProxyURI() const;
   virtual std::string GetTorVersion() const;
   virtual void GetTorLog(GetLogCallback);
+  // Speculatively builds a circuit that Tor binds to the isolation key of the
+  // first stream attached to it, so a request to a new site doesn't have to
+  // wait for a circuit to be built. The pool of unused circuits is bounded.
+  virtual void PrewarmCircuit();
+  size_t GetPrewarmedCircuitCountForTesting() const;
 
   void AddObserver(TorLauncherObserver* observer);
   void RemoveObserver(TorLauncherObserver* observer);
@@ -61,6 +68,7 @@ class TorLauncherFactory : public tor::TorControl::Delegate {
  private:
   friend struct base::DefaultSingletonTraits<TorLauncherFactory>;
   friend class MockTorLauncherFactory;
+  friend class TorLauncherFactoryTest;
 
   TorLauncherFactory();
   ~TorLauncherFactory() override;
@@ -79,6 +87,9 @@ class TorLauncherFactory : public tor::TorControl::Delegate {
   void GotVersion(bool error, const std::string& version);
   void GotSOCKSListeners(bool error, const std::vector<std::string>& listeners);
   void GotCircuitEstablished(bool error, bool established);
+  void OnCircuitPrewarmed(bool error, const std::string& circuit_id);
+  void MaybeConsumePrewarmedCircuit(const std::string& stream_event);
+  void ClearExpiredPrewarmedCircuits();
 
   void LaunchTorInternal();
   void RelaunchTor();
@@ -100,6 +111,11 @@ class TorLauncherFactory : public tor::TorControl::Delegate {
 
   std::unique_ptr<tor::TorControl, base::OnTaskRunnerDeleter> control_;
 
+  // Circuits built by PrewarmCircuit() that no stream has used yet, keyed by
+  // circuit id.
+  std::map<std::string, base::TimeTicks> prewarmed_circuits_;
+  size_t pending_prewarmed_circuits_ = 0;
+
   SEQUENCE_CHECKER(sequence_checker_);
 
   base::WeakPtrFactory<TorLauncherFactory> weak_ptr_factory_;
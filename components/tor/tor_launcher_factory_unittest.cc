@@ -0,0 +1,119 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/tor/tor_launcher_factory.h"
+
+#include <map>
+#include <string>
+
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+class TorLauncherFactoryTest : public testing::Test {
+ public:
+  TorLauncherFactoryTest() = default;
+  ~TorLauncherFactoryTest() override = default;
+
+  void SetUp() override { factory_ = new TorLauncherFactory; }
+
+  void TearDown() override { delete factory_; }
+
+ protected:
+  TorLauncherFactory* factory() { return factory_; }
+
+  void SetConnected(bool connected) { factory_->is_connected_ = connected; }
+
+  size_t GetPendingCircuitCount() {
+    return factory_->pending_prewarmed_circuits_;
+  }
+
+  // Pretends Tor replied to the EXTENDCIRCUIT sent by PrewarmCircuit().
+  void CircuitPrewarmed(const std::string& circuit_id) {
+    factory_->OnCircuitPrewarmed(false, circuit_id);
+  }
+
+  void StreamEvent(const std::string& initial) {
+    factory_->OnTorEvent(tor::TorControlEvent::STREAM, initial,
+                         std::map<std::string, std::string>());
+  }
+
+  content::BrowserTaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+
+ private:
+  TorLauncherFactory* factory_ = nullptr;
+};
+
+TEST_F(TorLauncherFactoryTest, PrewarmCircuitNeedsConnection) {
+  SetConnected(false);
+  factory()->PrewarmCircuit();
+  EXPECT_EQ(0u, GetPendingCircuitCount());
+}
+
+TEST_F(TorLauncherFactoryTest, FillsPoolUpToLimit) {
+  SetConnected(true);
+  for (int i = 0; i < 5; ++i)
+    factory()->PrewarmCircuit();
+  // Requests in flight count towards the limit.
+  EXPECT_EQ(3u, GetPendingCircuitCount());
+
+  CircuitPrewarmed("1");
+  CircuitPrewarmed("2");
+  CircuitPrewarmed("3");
+  EXPECT_EQ(0u, GetPendingCircuitCount());
+  EXPECT_EQ(3u, factory()->GetPrewarmedCircuitCountForTesting());
+
+  factory()->PrewarmCircuit();
+  EXPECT_EQ(0u, GetPendingCircuitCount());
+  EXPECT_EQ(3u, factory()->GetPrewarmedCircuitCountForTesting());
+}
+
+TEST_F(TorLauncherFactoryTest, ConsumesCircuitUsedByStream) {
+  SetConnected(true);
+  factory()->PrewarmCircuit();
+  factory()->PrewarmCircuit();
+  CircuitPrewarmed("5");
+  CircuitPrewarmed("6");
+  EXPECT_EQ(2u, factory()->GetPrewarmedCircuitCountForTesting());
+
+  // No circuit is picked for a new stream yet.
+  StreamEvent("12 NEW 0 example.com:443 SOURCE_ADDR=127.0.0.1:5000");
+  // Streams on other circuits leave the pool alone.
+  StreamEvent("13 SENTCONNECT 7 example.org:443");
+  EXPECT_EQ(2u, factory()->GetPrewarmedCircuitCountForTesting());
+
+  StreamEvent("12 SENTCONNECT 5 example.com:443");
+  EXPECT_EQ(1u, factory()->GetPrewarmedCircuitCountForTesting());
+  StreamEvent("14 SENTRESOLVE 6 example.net:0");
+  EXPECT_EQ(0u, factory()->GetPrewarmedCircuitCountForTesting());
+
+  // The pool has room again.
+  factory()->PrewarmCircuit();
+  EXPECT_EQ(1u, GetPendingCircuitCount());
+}
+
+TEST_F(TorLauncherFactoryTest, EvictsExpiredCircuits) {
+  SetConnected(true);
+  factory()->PrewarmCircuit();
+  CircuitPrewarmed("5");
+  task_environment_.FastForwardBy(base::TimeDelta::FromMinutes(5));
+  factory()->PrewarmCircuit();
+  CircuitPrewarmed("6");
+  EXPECT_EQ(2u, factory()->GetPrewarmedCircuitCountForTesting());
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromMinutes(6));
+  factory()->PrewarmCircuit();
+  EXPECT_EQ(1u, factory()->GetPrewarmedCircuitCountForTesting());
+}
+
+TEST_F(TorLauncherFactoryTest, ForgetsCircuitsWhenControlCloses) {
+  SetConnected(true);
+  factory()->PrewarmCircuit();
+  CircuitPrewarmed("5");
+  EXPECT_EQ(1u, factory()->GetPrewarmedCircuitCountForTesting());
+
+  factory()->OnTorControlClosed(false);
+  EXPECT_EQ(0u, factory()->GetPrewarmedCircuitCountForTesting());
+}
@@ -12,6 +12,8 @@
 #include "base/macros.h"
 #include "components/keyed_service/core/keyed_service.h"
 
+class GURL;
+
 namespace base {
 class FilePath;
 }
@@ -44,6 +46,9 @@ class TorProfileService : public KeyedService {
   virtual void RegisterTorClientUpdater() = 0;
   virtual void UnregisterTorClientUpdater() = 0;
   virtual void SetNewTorCircuit(content::WebContents* web_contents) = 0;
+  // Called with URLs the user is likely to visit next so a circuit for them
+  // can be built ahead of the first request.
+  virtual void PrewarmCircuitForURL(const GURL& url) = 0;
   virtual std::unique_ptr<net::ProxyConfigService>
       CreateProxyConfigService() = 0;
   virtual bool IsTorConnected() = 0;
@@ -10,6 +10,7 @@
 #include <utility>
 
 #include "base/bind.h"
+#include "base/strings/string_util.h"
 #include "base/task/post_task.h"
 #include "brave/components/tor/pref_names.h"
 #include "brave/components/tor/tor_constants.h"
@@ -30,6 +31,7 @@
 #include "net/url_request/url_request_context.h"
 #include "services/network/public/mojom/network_context.mojom.h"
 #include "services/network/public/mojom/proxy_lookup_client.mojom.h"
+#include "url/gurl.h"
 
 using content::BrowserContext;
 using content::BrowserThread;
@@ -41,6 +43,10 @@ namespace tor {
 
 namespace {
 
+// Don't ask for another circuit for an isolation key more often than this.
+// Matches the lifetime of the SOCKS credentials of a circuit isolation key.
+constexpr base::TimeDelta kPrewarmInterval = base::TimeDelta::FromMinutes(10);
+
 class NewTorCircuitTracker : public WebContentsObserver {
  public:
   explicit NewTorCircuitTracker(content::WebContents* web_contents)
@@ -207,6 +213,33 @@ void TorProfileServiceImpl::SetNewTorCircuit(WebContents* tab) {
       url, network_isolation_key, std::move(proxy_lookup_client));
 }
 
+void TorProfileServiceImpl::PrewarmCircuitForURL(const GURL& url) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!tor_launcher_factory_ || !url.SchemeIsHTTPOrHTTPS())
+    return;
+  // Onion services are reached through rendezvous circuits, a general purpose
+  // circuit is of no use to them.
+  if (base::EndsWith(url.host_piece(), ".onion",
+                     base::CompareCase::INSENSITIVE_ASCII))
+    return;
+  const std::string key = net::ProxyConfigServiceTor::CircuitIsolationKey(url);
+  if (key.empty())
+    return;
+
+  const base::TimeTicks now = base::TimeTicks::Now();
+  for (auto it = prewarmed_isolation_keys_.begin();
+       it != prewarmed_isolation_keys_.end();) {
+    if (now - it->second >= kPrewarmInterval)
+      it = prewarmed_isolation_keys_.erase(it);
+    else
+      ++it;
+  }
+  if (!prewarmed_isolation_keys_.emplace(key, now).second)
+    return;
+
+  tor_launcher_factory_->PrewarmCircuit();
+}
+
 void TorProfileServiceImpl::KillTor() {
   if (tor_launcher_factory_)
     tor_launcher_factory_->KillTorProcess();
@@ -6,11 +6,13 @@
 #ifndef BRAVE_COMPONENTS_TOR_TOR_PROFILE_SERVICE_IMPL_H_
 #define BRAVE_COMPONENTS_TOR_TOR_PROFILE_SERVICE_IMPL_H_
 
+#include <map>
 #include <memory>
 #include <string>
 
 #include "base/memory/weak_ptr.h"
 #include "base/optional.h"
+#include "base/time/time.h"
 #include "brave/components/tor/brave_tor_client_updater.h"
 #include "brave/components/tor/tor_launcher_factory.h"
 #include "brave/components/tor/tor_launcher_observer.h"
@@ -43,6 +45,7 @@ class TorProfileServiceImpl : public TorProfileService,
   void RegisterTorClientUpdater() override;
   void UnregisterTorClientUpdater() override;
   void SetNewTorCircuit(content::WebContents* web_contents) override;
+  void PrewarmCircuitForURL(const GURL& url) override;
   std::unique_ptr<net::ProxyConfigService> CreateProxyConfigService() override;
   bool IsTorConnected() override;
   void KillTor() override;
@@ -65,6 +68,8 @@ class TorProfileServiceImpl : public TorProfileService,
   BraveTorClientUpdater* tor_client_updater_ = nullptr;
   TorLauncherFactory* tor_launcher_factory_;  // Singleton
   net::ProxyConfigServiceTor* proxy_config_service_;  // NOT OWNED
+  // Circuit isolation keys a circuit was recently prewarmed for.
+  std::map<std::string, base::TimeTicks> prewarmed_isolation_keys_;
   base::WeakPtrFactory<TorProfileServiceImpl> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(TorProfileServiceImpl);
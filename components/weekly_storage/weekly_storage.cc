@@ -5,23 +5,30 @@
 
 #include "brave/components/weekly_storage/weekly_storage.h"
 
-#include <numeric>
+#include <algorithm>
 #include <utility>
+#include <vector>
 
+#include "base/bind.h"
 #include "base/time/clock.h"
 #include "base/time/default_clock.h"
 #include "base/values.h"
 #include "components/prefs/pref_service.h"
 #include "components/prefs/scoped_user_pref_update.h"
 
-namespace {
-constexpr size_t kDaysInWeek = 7;
-}
+// static
+constexpr size_t WeeklyStorage::kDaysInWeek;
 
 WeeklyStorage::WeeklyStorage(PrefService* prefs, const char* pref_name)
+    : WeeklyStorage(prefs, pref_name, base::TimeDelta()) {}
+
+WeeklyStorage::WeeklyStorage(PrefService* prefs,
+                             const char* pref_name,
+                             base::TimeDelta flush_delay)
     : prefs_(prefs),
       pref_name_(pref_name),
-      clock_(std::make_unique<base::DefaultClock>()) {
+      clock_(std::make_unique<base::DefaultClock>()),
+      flush_delay_(flush_delay) {
   DCHECK(pref_name);
   if (prefs) {
     Load();
@@ -30,124 +37,161 @@ WeeklyStorage::WeeklyStorage(PrefService* prefs, const char* pref_name)
 
 WeeklyStorage::WeeklyStorage(PrefService* prefs,
                              const char* pref_name,
-                             std::unique_ptr<base::Clock> clock)
-    : prefs_(prefs), pref_name_(pref_name), clock_(std::move(clock)) {
+                             std::unique_ptr<base::Clock> clock,
+                             base::TimeDelta flush_delay)
+    : prefs_(prefs),
+      pref_name_(pref_name),
+      clock_(std::move(clock)),
+      flush_delay_(flush_delay) {
   DCHECK(prefs);
   DCHECK(pref_name);
   Load();
 }
 
-WeeklyStorage::~WeeklyStorage() = default;
+WeeklyStorage::~WeeklyStorage() {
+  Flush();
+}
 
 void WeeklyStorage::AddDelta(uint64_t delta) {
-  FilterToWeek();
-  daily_values_.front().value += delta;
-  Save();
+  const bool day_changed = FilterToWeek();
+  daily_values_[head_].value += delta;
+  ScheduleSave(day_changed);
 }
 
 void WeeklyStorage::ReplaceTodaysValueIfGreater(uint64_t value) {
-  FilterToWeek();
-  DailyValue& today = daily_values_.front();
+  const bool day_changed = FilterToWeek();
+  DailyValue& today = daily_values_[head_];
   if (today.value < value) {
     today.value = value;
+  } else if (!day_changed) {
+    return;
   }
-  Save();
+  ScheduleSave(day_changed);
 }
 
 uint64_t WeeklyStorage::GetWeeklySum() const {
   // We record only value for last N days.
   const base::Time n_days_ago =
       clock_->Now() - base::TimeDelta::FromDays(kDaysInWeek);
-  return std::accumulate(daily_values_.begin(), daily_values_.end(), 0ull,
-                         [n_days_ago](const uint64_t acc, const auto& u2) {
-                           uint64_t add = 0;
-                           // Check only last continious days.
-                           if (u2.day > n_days_ago) {
-                             add = u2.value;
-                           }
-                           return acc + add;
-                         });
+  uint64_t sum = 0;
+  for (size_t i = 0; i < size_; ++i) {
+    const DailyValue& daily_value = GetDailyValue(i);
+    // Check only last continious days.
+    if (daily_value.day > n_days_ago) {
+      sum += daily_value.value;
+    }
+  }
+  return sum;
 }
 
 uint64_t WeeklyStorage::GetHighestValueInWeek() const {
   // We record only value for last N days.
   const base::Time n_days_ago =
       clock_->Now() - base::TimeDelta::FromDays(kDaysInWeek);
-  std::list<DailyValue> last_weeks_daily_values(daily_values_.size());
-  auto copied_it =
-      std::copy_if(daily_values_.begin(), daily_values_.end(),
-                   last_weeks_daily_values.begin(),
-                   [n_days_ago](auto i) { return i.day > n_days_ago; });
-  last_weeks_daily_values.resize(
-      std::distance(last_weeks_daily_values.begin(), copied_it));
-
-  auto highest_it = std::max_element(last_weeks_daily_values.begin(),
-                                     last_weeks_daily_values.end(),
-                                     [](const auto& left, const auto& right) {
-                                       return left.value < right.value;
-                                     });
-  if (highest_it == last_weeks_daily_values.end()) {
-    return 0;
+  uint64_t highest = 0;
+  for (size_t i = 0; i < size_; ++i) {
+    const DailyValue& daily_value = GetDailyValue(i);
+    if (daily_value.day > n_days_ago) {
+      highest = std::max(highest, daily_value.value);
+    }
   }
-  return highest_it->value;
+  return highest;
 }
 
 bool WeeklyStorage::IsOneWeekPassed() const {
   // TODO(iefremov): This is not true 100% (if the browser was launched once
   // per week just after installation, for example).
-  return daily_values_.size() == kDaysInWeek;
+  return size_ == kDaysInWeek;
 }
 
-void WeeklyStorage::FilterToWeek() {
+void WeeklyStorage::Flush() {
+  if (save_timer_.IsRunning()) {
+    Save();
+  }
+}
+
+const WeeklyStorage::DailyValue& WeeklyStorage::GetDailyValue(
+    size_t days_ago) const {
+  DCHECK_LT(days_ago, size_);
+  return daily_values_[(head_ + kDaysInWeek - days_ago) % kDaysInWeek];
+}
+
+bool WeeklyStorage::FilterToWeek() {
   base::Time now_midnight = clock_->Now().LocalMidnight();
   base::Time last_saved_midnight;
 
-  if (!daily_values_.empty()) {
-    last_saved_midnight = daily_values_.front().day;
+  if (size_ > 0) {
+    last_saved_midnight = daily_values_[head_].day;
   }
 
   if (now_midnight - last_saved_midnight > base::TimeDelta()) {
     // Day changed. Since we consider only small incoming intervals, lets just
-    // save it with a new timestamp.
-    daily_values_.push_front({now_midnight, 0});
-    if (daily_values_.size() > kDaysInWeek) {
-      daily_values_.pop_back();
-    }
+    // save it with a new timestamp, overwriting the oldest day if needed.
+    head_ = (head_ + 1) % kDaysInWeek;
+    daily_values_[head_] = {now_midnight, 0};
+    size_ = std::min(size_ + 1, kDaysInWeek);
+    return true;
   }
+  return false;
 }
 
 void WeeklyStorage::Load() {
-  DCHECK(daily_values_.empty());
+  DCHECK_EQ(size_, 0u);
   const base::ListValue* list = prefs_->GetList(pref_name_);
   if (!list) {
     return;
   }
+  // The list is stored from the most recent day back.
+  std::vector<DailyValue> loaded;
   for (auto it = list->begin(); it != list->end(); ++it) {
     const base::Value* day = it->FindKey("day");
     const base::Value* value = it->FindKey("value");
     if (!day || !value || !day->is_double() || !value->is_double()) {
       continue;
     }
-    if (daily_values_.size() == kDaysInWeek) {
+    if (loaded.size() == kDaysInWeek) {
       break;
     }
-    daily_values_.push_back({base::Time::FromDoubleT(day->GetDouble()),
-                             static_cast<uint64_t>(value->GetDouble())});
+    loaded.push_back({base::Time::FromDoubleT(day->GetDouble()),
+                      static_cast<uint64_t>(value->GetDouble())});
+  }
+  if (loaded.empty()) {
+    return;
+  }
+  size_ = loaded.size();
+  head_ = size_ - 1;
+  for (size_t i = 0; i < size_; ++i) {
+    daily_values_[head_ - i] = loaded[i];
   }
 }
 
 void WeeklyStorage::Save() {
-  DCHECK(!daily_values_.empty());
-  DCHECK_LE(daily_values_.size(), kDaysInWeek);
+  DCHECK_GT(size_, 0u);
+  DCHECK_LE(size_, kDaysInWeek);
+  save_timer_.Stop();
 
   ListPrefUpdate update(prefs_, pref_name_);
   base::ListValue* list = update.Get();
-  // TODO(iefremov): Optimize if needed.
   list->Clear();
-  for (const auto& u : daily_values_) {
+  for (size_t i = 0; i < size_; ++i) {
+    const DailyValue& daily_value = GetDailyValue(i);
     base::DictionaryValue value;
-    value.SetKey("day", base::Value(u.day.ToDoubleT()));
-    value.SetDoubleKey("value", u.value);
+    value.SetKey("day", base::Value(daily_value.day.ToDoubleT()));
+    value.SetDoubleKey("value", daily_value.value);
     list->Append(std::move(value));
   }
 }
+
+void WeeklyStorage::ScheduleSave(bool day_changed) {
+  // A new day moves the window, so the previous days are written right away
+  // rather than left to a timer that might never fire.
+  if (flush_delay_.is_zero() || day_changed) {
+    Save();
+    return;
+  }
+  if (!save_timer_.IsRunning()) {
+    save_timer_.Start(
+        FROM_HERE, flush_delay_,
+        base::BindOnce(&WeeklyStorage::Save, base::Unretained(this)));
+  }
+}
@@ -6,10 +6,11 @@
 #ifndef BRAVE_COMPONENTS_WEEKLY_STORAGE_WEEKLY_STORAGE_H_
 #define BRAVE_COMPONENTS_WEEKLY_STORAGE_WEEKLY_STORAGE_H_
 
-#include <list>
+#include <array>
 #include <memory>
 
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 
 namespace base {
 class Clock;
@@ -25,11 +26,19 @@ class PrefService;
 class WeeklyStorage {
  public:
   WeeklyStorage(PrefService* prefs, const char* pref_name);
+  // Batched mode for long-lived counters that are bumped often: updates are
+  // kept in memory and written at most once per |flush_delay|, on day change
+  // and on destruction. A crash loses at most |flush_delay| worth of updates.
+  // Only one instance should own |pref_name| in this mode.
+  WeeklyStorage(PrefService* prefs,
+                const char* pref_name,
+                base::TimeDelta flush_delay);
 
   // For tests.
   WeeklyStorage(PrefService* user_prefs,
                 const char* pref_name,
-                std::unique_ptr<base::Clock> clock);
+                std::unique_ptr<base::Clock> clock,
+                base::TimeDelta flush_delay = base::TimeDelta());
   ~WeeklyStorage();
 
   WeeklyStorage(const WeeklyStorage&) = delete;
@@ -40,21 +49,34 @@ class WeeklyStorage {
   uint64_t GetWeeklySum() const;
   uint64_t GetHighestValueInWeek() const;
   bool IsOneWeekPassed() const;
+  // Writes pending updates of the batched mode right away.
+  void Flush();
 
  private:
+  static constexpr size_t kDaysInWeek = 7;
+
   struct DailyValue {
     base::Time day;
     uint64_t value = 0ull;
   };
-  void FilterToWeek();
+  // Returns the value recorded |days_ago| entries back, 0 being today.
+  const DailyValue& GetDailyValue(size_t days_ago) const;
+  // Returns true if a new day was started.
+  bool FilterToWeek();
   void Load();
   void Save();
+  void ScheduleSave(bool day_changed);
 
   PrefService* prefs_ = nullptr;
   const char* pref_name_ = nullptr;
   std::unique_ptr<base::Clock> clock_;
+  const base::TimeDelta flush_delay_;
+  base::OneShotTimer save_timer_;
 
-  std::list<DailyValue> daily_values_;
+  // Ring of the last |kDaysInWeek| days, |head_| is the most recent one.
+  std::array<DailyValue, kDaysInWeek> daily_values_;
+  size_t head_ = 0;
+  size_t size_ = 0;
 };
 
 #endif  // BRAVE_COMPONENTS_WEEKLY_STORAGE_WEEKLY_STORAGE_H_
@@ -8,27 +8,62 @@
 #include <memory>
 #include <utility>
 
+#include "base/bind.h"
 #include "base/test/simple_test_clock.h"
+#include "base/test/task_environment.h"
 #include "base/time/time.h"
+#include "components/prefs/pref_change_registrar.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/testing_pref_service.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+constexpr char kPrefName[] = "brave.weekly_test";
+constexpr char kBatchedPrefName[] = "brave.weekly_batched_test";
+constexpr base::TimeDelta kFlushDelay = base::TimeDelta::FromSeconds(30);
+}  // namespace
+
 class WeeklyStorageTest : public ::testing::Test {
  public:
   WeeklyStorageTest() : clock_(new base::SimpleTestClock) {
-    constexpr char kPrefName[] = "brave.weekly_test";
     pref_service_.registry()->RegisterListPref(kPrefName);
+    pref_service_.registry()->RegisterListPref(kBatchedPrefName);
 
     state_ = std::make_unique<WeeklyStorage>(
         &pref_service_, kPrefName, std::unique_ptr<base::Clock>(clock_));
     clock_->SetNow(base::Time::Now());
+
+    pref_change_registrar_.Init(&pref_service_);
+    pref_change_registrar_.Add(
+        kBatchedPrefName,
+        base::BindRepeating([](int* writes) { ++*writes; }, &batched_writes_));
   }
 
  protected:
+  std::unique_ptr<WeeklyStorage> CreateBatchedStorage() {
+    auto* clock = new base::SimpleTestClock;
+    clock->SetNow(clock_->Now());
+    batched_clock_ = clock;
+    return std::make_unique<WeeklyStorage>(
+        &pref_service_, kBatchedPrefName, std::unique_ptr<base::Clock>(clock),
+        kFlushDelay);
+  }
+
+  uint64_t GetStoredWeeklySum() {
+    auto clock = std::make_unique<base::SimpleTestClock>();
+    clock->SetNow(clock_->Now());
+    WeeklyStorage storage(&pref_service_, kBatchedPrefName, std::move(clock));
+    return storage.GetWeeklySum();
+  }
+
+  base::test::SingleThreadTaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
   base::SimpleTestClock* clock_;
+  base::SimpleTestClock* batched_clock_ = nullptr;
   TestingPrefServiceSimple pref_service_;
   std::unique_ptr<WeeklyStorage> state_;
+  PrefChangeRegistrar pref_change_registrar_;
+  int batched_writes_ = 0;
 };
 
 TEST_F(WeeklyStorageTest, StartsZero) {
@@ -138,3 +173,76 @@ TEST_F(WeeklyStorageTest, GetsHighestValueInWeekFromReplacement) {
   // Sanity check disparate days were not replaced
   EXPECT_EQ(state_->GetWeeklySum(), high_value + low_value);
 }
+
+TEST_F(WeeklyStorageTest, BatchesWrites) {
+  auto storage = CreateBatchedStorage();
+  for (int i = 0; i < 100; i++)
+    storage->AddDelta(1);
+  EXPECT_EQ(storage->GetWeeklySum(), 100ULL);
+  EXPECT_EQ(batched_writes_, 1);  // The first value starts a new day.
+
+  for (int i = 0; i < 100; i++)
+    storage->AddDelta(1);
+  EXPECT_EQ(batched_writes_, 1);
+
+  task_environment_.FastForwardBy(kFlushDelay);
+  EXPECT_EQ(batched_writes_, 2);
+
+  // Nothing pending, nothing to write.
+  task_environment_.FastForwardBy(kFlushDelay);
+  EXPECT_EQ(batched_writes_, 2);
+}
+
+TEST_F(WeeklyStorageTest, BoundsUnsavedUpdates) {
+  auto storage = CreateBatchedStorage();
+  storage->AddDelta(1);
+  storage->AddDelta(10);
+  // A crash now would lose the updates of the last |kFlushDelay| only.
+  EXPECT_EQ(GetStoredWeeklySum(), 1ULL);
+  const base::TimeDelta one_second = base::TimeDelta::FromSeconds(1);
+  task_environment_.FastForwardBy(kFlushDelay - one_second);
+  EXPECT_EQ(GetStoredWeeklySum(), 1ULL);
+  task_environment_.FastForwardBy(one_second);
+  EXPECT_EQ(GetStoredWeeklySum(), 11ULL);
+}
+
+TEST_F(WeeklyStorageTest, FlushesOnDayChange) {
+  auto storage = CreateBatchedStorage();
+  storage->AddDelta(1);
+  storage->AddDelta(10);
+  EXPECT_EQ(batched_writes_, 1);
+
+  batched_clock_->Advance(base::TimeDelta::FromDays(1));
+  storage->AddDelta(100);
+  EXPECT_EQ(batched_writes_, 2);
+  EXPECT_EQ(GetStoredWeeklySum(), 111ULL);
+}
+
+TEST_F(WeeklyStorageTest, FlushesOnDestruction) {
+  auto storage = CreateBatchedStorage();
+  storage->AddDelta(1);
+  storage->ReplaceTodaysValueIfGreater(50);
+  EXPECT_EQ(GetStoredWeeklySum(), 1ULL);
+
+  storage.reset();
+  EXPECT_EQ(batched_writes_, 2);
+  EXPECT_EQ(GetStoredWeeklySum(), 50ULL);
+}
+
+TEST_F(WeeklyStorageTest, KeepsLastWeekAcrossReload) {
+  uint64_t saving = 10000;
+  for (int day = 0; day < 10; day++) {
+    clock_->Advance(base::TimeDelta::FromDays(1));
+    state_->AddDelta(saving * (day + 1));
+  }
+  EXPECT_TRUE(state_->IsOneWeekPassed());
+  const uint64_t weekly_sum = state_->GetWeeklySum();
+
+  auto* clock = new base::SimpleTestClock;
+  clock->SetNow(clock_->Now());
+  WeeklyStorage reloaded(&pref_service_, kPrefName,
+                         std::unique_ptr<base::Clock>(clock));
+  EXPECT_TRUE(reloaded.IsOneWeekPassed());
+  EXPECT_EQ(reloaded.GetWeeklySum(), weekly_sum);
+  EXPECT_EQ(reloaded.GetHighestValueInWeek(), saving * 10);
+}